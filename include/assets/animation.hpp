@@ -0,0 +1,89 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aero_boar {
+
+// Clips are resampled at this rate when cooked, whatever their key times
+constexpr float kAnimationSampleRate = 30.0f;
+
+// Local transform of a node, in the form animations drive
+struct NodePose {
+    glm::vec3 translation = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+// A model's nodes flattened in preorder, so parents precede their children
+struct Skeleton {
+    std::vector<int32_t> parents; // -1 for the root
+    std::vector<NodePose> restPoses;
+    // Morph target weights of all nodes back to back; node i owns
+    // [firstMorphWeights[i], firstMorphWeights[i + 1])
+    std::vector<uint32_t> firstMorphWeights;
+    std::vector<float> restMorphWeights;
+};
+
+// Joints are skeleton node indices; empty when the skin could not be resolved
+struct Skin {
+    std::vector<uint32_t> joints;
+    std::vector<glm::mat4> inverseBindMatrices;
+};
+
+// A mesh placed under a node with a skin, drawn through the skinning pass
+struct SkinBinding {
+    uint32_t mesh = 0;
+    uint32_t skin = 0;
+    uint32_t node = 0; // Supplies the mesh's morph target weights
+};
+
+enum class AnimationPath : uint32_t {
+    Translation,
+    Rotation,
+    Scale,
+    Weights, // One morph target weight
+};
+
+// One animated property of one node. Rotations are stored as snorm16
+// quaternions, translations, scales and weights as unorm16 within the
+// track's range. A track that is constant over the clip keeps a single sample.
+struct AnimationTrack {
+    uint32_t node = 0;
+    AnimationPath path = AnimationPath::Translation;
+    uint32_t firstSample = 0; // Index into AnimationClip::samples
+    uint32_t sampleCount = 0; // frameCount, or 1 when constant
+    uint32_t morphWeight = 0; // Weights: index into Skeleton::restMorphWeights
+    glm::vec3 rangeMin = glm::vec3(0.0f);
+    glm::vec3 rangeExtent = glm::vec3(0.0f);
+};
+
+// An animation resampled at evenly spaced frames, so evaluating it is two
+// sample reads and a blend per track, with no key search
+struct AnimationClip {
+    std::string name;
+    float duration = 0.0f;
+    float sampleRate = kAnimationSampleRate; // Frames per second; spacing is exact at both ends
+    uint32_t frameCount = 0;
+    std::vector<AnimationTrack> tracks;
+    std::vector<uint16_t> samples;
+};
+
+// Quantizes a property sampled at each of the clip's frames (xyz for
+// translation and scale, xyzw for rotation, x for a weight) and appends it
+// as a track
+void AppendAnimationTrack(AnimationClip& clip, uint32_t node, AnimationPath path,
+                          const std::vector<glm::vec4>& values, uint32_t morphWeight = 0);
+
+// Poses the nodes the clip animates at time seconds, looping, and sets the
+// morph weights it animates unless morphWeights is null. Poses and weights
+// the clip does not animate are left untouched.
+void SampleAnimationClip(const AnimationClip& clip, float time, NodePose* poses, float* morphWeights = nullptr);
+
+// Model-space transform of every skeleton node from its local pose
+void ComputeNodeTransforms(const Skeleton& skeleton, const NodePose* poses, glm::mat4* transforms);
+
+} // namespace aero_boar
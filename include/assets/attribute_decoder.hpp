@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aero_boar {
+
+// One accessor's elements as laid out in their buffer view
+struct AttributeStream {
+    const unsigned char* data = nullptr; // First element
+    size_t available = 0;                // Readable bytes from data to the end of the buffer
+    size_t count = 0;
+    size_t stride = 0;                   // Bytes between consecutive elements
+    int componentType = 0;               // glTF componentType, 5120 (BYTE) to 5126 (FLOAT)
+    uint32_t components = 0;             // 1 to 4
+    bool normalized = false;
+};
+
+// Bytes per component; 0 for types the decoder does not know
+size_t GetComponentSize(int componentType);
+
+// Converts every element to floats, written as dstComponents floats per
+// element, dstStride bytes apart. Integer components are normalized when the
+// stream says so; components the source lacks take the matching fill value.
+// Fails for unknown component types and streams that overrun their buffer.
+bool DecodeAttribute(const AttributeStream& source, float* dst, size_t dstStride, uint32_t dstComponents,
+                     const float fill[4]);
+
+// Writes the first dstComponents of value to count elements dstStride bytes apart
+void FillAttribute(float* dst, size_t dstStride, size_t count, uint32_t dstComponents, const float value[4]);
+
+} // namespace aero_boar
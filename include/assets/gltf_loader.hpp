@@ -6,6 +6,9 @@
 #include <glm/gtc/quaternion.hpp>
 #include <vk_mem_alloc.h>
 #include <tiny_gltf.h>
+#include "core/transfer_manager.hpp"
+#include "core/geometry_arena.hpp"
+#include "assets/animation.hpp"
 #include <vector>
 #include <memory>
 #include <string>
@@ -23,6 +26,12 @@ namespace aero_boar {
 
 // Forward declarations
 class Renderer;
+class MeshCache;
+struct CookedModel;
+struct CookedMesh;
+struct CookedImage;
+struct CookedTexture;
+struct CookedNode;
 
 // Asset structures
 struct Vertex {
@@ -32,30 +41,112 @@ struct Vertex {
     glm::vec4 color = glm::vec4(1.0f); // Default white color
 };
 
+// Compact vertex (20 bytes) for meshes whose bounds and attributes fit it.
+// Positions are snorm16 within the mesh bounds, normals octahedral snorm16,
+// texture coordinates half floats and colors unorm8.
+struct PackedVertex {
+    int16_t position[4]; // w is padding: 3-component 16-bit vertex formats are optional in Vulkan
+    int16_t normal[2];
+    uint16_t texCoord[2];
+    uint8_t color[4];
+};
+
+// Bind-pose vertex of a skinned mesh. The skinning pass reads it and writes
+// a posed Vertex for every animated instance.
+struct SkinnedVertex {
+    Vertex vertex;
+    uint16_t joints[4];  // Indices into the joints of the node's skin
+    uint16_t weights[4]; // unorm16, summing to 65535
+};
+
+// Offset of one vertex under one morph target. Meshes keep only non-zero
+// deltas, grouped by vertex; 32 bytes, matching MorphDelta in skinning.comp.
+struct MorphDelta {
+    glm::vec3 position = glm::vec3(0.0f);
+    uint32_t target = 0;
+    glm::vec3 normal = glm::vec3(0.0f);
+    uint32_t padding = 0;
+};
+
+// Vertex layout of a mesh; each has its own geometry arena and pipeline
+enum class VertexFormat : uint32_t {
+    Float32, // Vertex
+    Packed,  // PackedVertex
+    Skinned, // SkinnedVertex, posed by SkinningSystem into Vertex
+};
+
+struct Texture {
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkSampler sampler = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED; // sRGB for color slots, UNORM for data
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+};
+
+// Texture slots index into Model::textures; -1 when the slot is unused
 struct Material {
     glm::vec4 baseColorFactor = glm::vec4(1.0f);
     float metallicFactor = 0.0f;
     float roughnessFactor = 1.0f;
-    VkImage baseColorTexture = VK_NULL_HANDLE;
-    VkImageView baseColorTextureView = VK_NULL_HANDLE;
-    VkSampler baseColorSampler = VK_NULL_HANDLE;
-    VmaAllocation baseColorTextureAllocation = VK_NULL_HANDLE;
+    int baseColorTexture = -1;
+    int metallicRoughnessTexture = -1;
+    int normalTexture = -1;
+    int occlusionTexture = -1;
+    int emissiveTexture = -1;
 };
 
-struct Mesh {
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
-    VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    VkBuffer indexBuffer = VK_NULL_HANDLE;
-    VmaAllocation vertexBufferAllocation = VK_NULL_HANDLE;
-    VmaAllocation indexBufferAllocation = VK_NULL_HANDLE;
+// One glTF primitive: a slice of its mesh's geometry drawn with one material
+struct Submesh {
+    uint32_t firstIndex = 0;  // Relative to the mesh's first index
+    uint32_t indexCount = 0;
+    int32_t vertexOffset = 0; // Relative to the mesh's first vertex
     uint32_t materialIndex = 0;
     VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 };
 
+// How a triangle list uses the post-transform vertex cache
+struct VertexCacheStats {
+    uint32_t triangleCount = 0;
+    uint32_t vertexCount = 0;    // Distinct vertices referenced
+    uint32_t transformCount = 0; // Cache misses, each a vertex shader invocation
+
+    // Average cache miss ratio: transforms per triangle, 0.5 at best, 3 at worst
+    float GetAcmr() const { return triangleCount ? float(transformCount) / float(triangleCount) : 0.0f; }
+    // Average transform to vertex ratio: 1 when every vertex is shaded once
+    float GetAtvr() const { return vertexCount ? float(transformCount) / float(vertexCount) : 0.0f; }
+
+    void Add(const VertexCacheStats& other) {
+        triangleCount += other.triangleCount;
+        vertexCount += other.vertexCount;
+        transformCount += other.transformCount;
+    }
+};
+
+// All primitives of a mesh share one range of the geometry arena of its
+// vertex format; no CPU copy is kept
+struct Mesh {
+    GeometryHandle geometry = kInvalidGeometryHandle;
+    VertexFormat vertexFormat = VertexFormat::Float32;
+    // Packed positions decode as positionOffset + positionScale * snorm
+    glm::vec3 positionOffset = glm::vec3(0.0f);
+    glm::vec3 positionScale = glm::vec3(1.0f);
+    std::vector<Submesh> submeshes;
+    uint32_t jointCount = 0; // Skinned: highest joint index referenced, plus one
+    // Skinned meshes with morph targets: deltas in the morph arena
+    GeometryHandle morphGeometry = kInvalidGeometryHandle;
+    uint32_t morphTargetCount = 0;
+    // Triangle lists as imported and after import-time reordering
+    VertexCacheStats sourceCacheStats;
+    VertexCacheStats cacheStats;
+};
+
 struct Node {
     glm::mat4 transform = glm::mat4(1.0f);
     std::vector<uint32_t> meshIndices;
+    int32_t skin = -1; // Index into Model::skins
     std::vector<std::unique_ptr<Node>> children;
     std::string name;
 };
@@ -63,19 +154,68 @@ struct Node {
 struct Model {
     std::vector<Mesh> meshes;
     std::vector<Material> materials;
+    std::vector<Texture> textures;
     std::unique_ptr<Node> rootNode;
+    // Nodes in preorder as animations pose them, and the skinned meshes they place
+    Skeleton skeleton;
+    std::vector<Skin> skins;
+    std::vector<SkinBinding> skinBindings;
+    std::vector<AnimationClip> animations;
     std::string name;
-    bool isLoaded = false;
+    std::atomic<bool> isLoaded{false}; // Set once the upload batch has retired
     std::string errorMessage;
+    TransferTicket uploadTicket; // Retires once all GPU uploads for the model are done
+    VkDeviceSize residentBytes = 0; // Geometry and texture memory, for eviction budgets
+    VkDeviceSize textureBytes = 0;  // Part of residentBytes in allocations of its own
+};
+
+// Ref-counted handle to a loaded model. The loader keeps its own reference;
+// eviction (EvictModel) frees its GPU memory but leaves handles valid.
+using ModelHandle = std::shared_ptr<Model>;
+
+struct AssetConfig {
+    // Directory of the cooked mesh cache; empty disables it
+    std::string meshCacheDirectory;
+
+    // Store meshes as PackedVertex when quantizing positions moves no vertex
+    // by more than packedPositionTolerance (model units)
+    bool packVertices = true;
+    float packedPositionTolerance = 0.0005f;
+
+    static AssetConfig LoadFromFile(const std::string& filepath);
+};
+
+// GPU memory a resident model holds, for residency decisions
+struct ModelResidency {
+    std::string name;
+    VkDeviceSize bytes = 0;
+    // Part of bytes that eviction returns to the heap; geometry only returns
+    // to its preallocated arena
+    VkDeviceSize textureBytes = 0;
+};
+
+// Bytes of one glTF buffer while its model is cooked
+struct BufferSpan {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
 };
 
 // Asset loading result
 struct AssetLoadResult {
-    std::shared_ptr<Model> model;
+    ModelHandle model;
     bool success = false;
     std::string errorMessage;
 };
 
+// Identifies a load started by GltfLoader::RequestModel; never 0
+using ModelRequestId = uint64_t;
+
+struct ModelLoadCompletion {
+    ModelRequestId request = 0;
+    std::string filepath;
+    AssetLoadResult result;
+};
+
 // Background thread pool for asset loading
 class AssetThreadPool {
 public:
@@ -95,75 +235,297 @@ private:
     std::atomic<bool> stop;
 };
 
-// Forward declaration
-class TransferManager;
+// Tasks of one load that must all finish before it moves on. Tasks run on
+// the pool, or inline without one. The waiter is usually a pool thread
+// itself, so it runs the group's tasks no worker has started yet, and sleeps
+// only while the rest are running elsewhere. It never runs other groups'
+// tasks, which could block it on unrelated work.
+class AssetTaskGroup {
+public:
+    explicit AssetTaskGroup(AssetThreadPool* pool);
+    ~AssetTaskGroup(); // Waits, so tasks never outlive what they reference
+
+    void Run(std::function<void()> task);
+    // Rethrows the first exception a task threw
+    void Wait();
+
+private:
+    // Shared with the pool, which may still hold a worker entry for a task
+    // the waiter already ran
+    struct State {
+        std::mutex mutex;
+        std::condition_variable changed; // A task queued or the last one finished
+        std::queue<std::function<void()>> queued; // Not yet started
+        size_t pending = 0;                       // Queued or running
+        std::exception_ptr error;
+    };
+
+    static bool RunQueuedTask(State& state);
+    void WaitAll();
+
+    AssetThreadPool* m_pool;
+    std::shared_ptr<State> m_state;
+};
 
 // Main glTF loader class
 class GltfLoader {
 public:
-    GltfLoader(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator);
+    GltfLoader(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator,
+               const TransferQueueInfo& transferQueue, uint32_t framesInFlight,
+               const TransferConfig& transferConfig = TransferConfig{},
+               const AssetConfig& assetConfig = AssetConfig{});
     ~GltfLoader();
 
     bool Initialize();
     void Shutdown();
 
-    // Async asset loading
-    std::future<AssetLoadResult> LoadModelAsync(const std::string& filepath);
+    // Async asset loading. Concurrent requests for the same file share one
+    // load and receive the same future.
+    std::shared_future<AssetLoadResult> LoadModelAsync(const std::string& filepath);
     
-    // Synchronous asset loading (for testing)
+    // Synchronous asset loading; joins a load of the same file already in flight.
+    // Blocks, so call it from outside the asset thread pool.
     AssetLoadResult LoadModel(const std::string& filepath);
+
+    // Fire-and-forget loading: returns at once, and the outcome is delivered
+    // by DrainCompletedLoads once the load finishes. Shares in-flight loads
+    // like LoadModelAsync. The model's uploads may still be in flight then.
+    ModelRequestId RequestModel(const std::string& filepath);
+    // Appends the loads completed since the last call, oldest first. Single
+    // consumer; call on the render thread.
+    void DrainCompletedLoads(std::vector<ModelLoadCompletion>& completions);
     
     // Create a simple cube model programmatically (for testing)
     AssetLoadResult CreateCubeModel();
 
-    // Get loaded model by name
-    std::shared_ptr<Model> GetModel(const std::string& name);
+    // Get loaded model by name; counts as a use for eviction order
+    ModelHandle GetModel(const std::string& name);
     
     // Check if model is loaded
     bool IsModelLoaded(const std::string& name);
 
-    // Cleanup model resources
+    // Cleanup model resources, even while handles to the model remain
     void UnloadModel(const std::string& name);
 
+    VkDeviceSize GetResidentBytes();
+
+    // Releases a model's GPU memory but keeps its entry and handles; it stops
+    // drawing (isLoaded is false) until ReloadModel brings it back. Fails for
+    // models with uploads in flight and for models not loaded from a file.
+    // Call from the render thread.
+    bool EvictModel(const std::string& name);
+    // Rebuilds an evicted model in the background. The rebuilt resources are
+    // swapped into the existing Model by UpdatePendingUploads once uploaded.
+    void ReloadModel(const std::string& name);
+    bool IsModelEvicted(const std::string& name);
+    std::vector<ModelResidency> GetResidentModels();
+
+    // Marks models whose upload batch has retired as loaded; call once per frame
+    void UpdatePendingUploads();
+    // Destroys textures of unloaded and evicted models once the frames that
+    // may still sample them have retired. Render thread, once per frame after
+    // the frame's fence has been waited on.
+    void BeginFrame();
+    // Memory of textures freed but not yet destroyed by BeginFrame
+    VkDeviceSize GetRetiredTextureBytes();
+
+    TransferManager* GetTransferManager() const { return m_transferManager.get(); }
+    // Null for VertexFormat::Packed when vertex packing is disabled
+    GeometryArena* GetGeometryArena(VertexFormat format = VertexFormat::Float32) const {
+        switch (format) {
+            case VertexFormat::Packed: return m_packedGeometryArena.get();
+            case VertexFormat::Skinned: return m_skinnedGeometryArena.get();
+            default: return m_geometryArena.get();
+        }
+    }
+    // Morph deltas as its vertices, each vertex's first delta as its indices
+    GeometryArena* GetMorphArena() const { return m_morphArena.get(); }
+
 private:
     VkDevice m_device = VK_NULL_HANDLE;
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
     VmaAllocator m_allocator = VK_NULL_HANDLE;
+    TransferQueueInfo m_transferQueue;
+    TransferConfig m_transferConfig;
+    AssetConfig m_assetConfig;
+    uint32_t m_framesInFlight = 0;
+    float m_maxSamplerAnisotropy = 1.0f;
     
     std::unique_ptr<AssetThreadPool> m_threadPool;
     std::unique_ptr<TransferManager> m_transferManager;
+    std::unique_ptr<GeometryArena> m_geometryArena;
+    std::unique_ptr<GeometryArena> m_packedGeometryArena;
+    std::unique_ptr<GeometryArena> m_skinnedGeometryArena;
+    std::unique_ptr<GeometryArena> m_morphArena;
+    std::unique_ptr<MeshCache> m_meshCache;
+
+    struct RetiredTexture {
+        Texture texture;
+        VkDeviceSize bytes = 0;
+        uint32_t framesLeft = 0;
+    };
+    std::mutex m_retiredTexturesMutex;
+    std::vector<RetiredTexture> m_retiredTextures;
+    VkDeviceSize m_retiredTextureBytes = 0;
     
-    std::unordered_map<std::string, std::shared_ptr<Model>> m_loadedModels;
+    struct LoadedModel {
+        ModelHandle model;
+        bool reloadable = true; // False for models not loaded from a file
+        bool evicted = false;
+        bool reloading = false;
+    };
+
+    // A reload's rebuilt model, swapped into the entry once its uploads retire
+    struct ReloadedModel {
+        std::string name;
+        ModelHandle model;
+    };
+
+    std::unordered_map<std::string, LoadedModel> m_loadedModels;
+    std::unordered_map<std::string, std::shared_future<AssetLoadResult>> m_inFlightLoads;
+    std::unordered_map<std::string, std::vector<ModelRequestId>> m_loadRequests; // Waiting on in-flight loads
+    std::vector<ModelHandle> m_pendingModels; // Uploads still in flight
+    std::vector<ReloadedModel> m_reloadedModels;
+    VkDeviceSize m_residentBytes = 0;
     std::mutex m_modelsMutex;
     std::atomic<bool> m_shutdown{false};
 
-    // glTF parsing methods
+    // Loaders push onto a lock-free intrusive stack that DrainCompletedLoads
+    // empties, so completing a load never waits on the render thread
+    struct CompletedLoad {
+        ModelLoadCompletion completion;
+        CompletedLoad* next = nullptr;
+    };
+    std::atomic<CompletedLoad*> m_completedHead{nullptr};
+    std::atomic<ModelRequestId> m_nextRequestId{1};
+
+    // Encoded image bytes by image index: copies kept by the tinygltf image
+    // callback, or spans of a mapped GLB's BIN chunk
+    struct EncodedImages {
+        std::vector<std::vector<unsigned char>> copies;
+        std::vector<BufferSpan> images;
+    };
+
+    // Buffers of a glTF being cooked, indexed like tinygltf::Model::buffers
+    // and then by decoded meshopt views. A GLB's BIN chunk is read in place
+    // from the mapped file; decoded views are stored here.
+    struct GltfBuffers {
+        std::vector<BufferSpan> spans;
+        std::vector<std::vector<unsigned char>> decoded;
+    };
+
+    // Pixels decoded on the thread pool: RGBA8 from PNG/JPEG, or the levels
+    // of a KTX2 payload in its own (usually block-compressed) format
+    struct DecodedImage {
+        std::vector<unsigned char> pixels;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED; // Undefined means RGBA8 in the slot's color space
+        uint32_t mipLevels = 1;
+        std::vector<VkDeviceSize> levelOffsets;
+    };
+
+    // Vertex and index arrays a freshly parsed CookedModel points into
+    struct CookedGeometry {
+        std::vector<std::vector<Vertex>> vertices;
+        std::vector<std::vector<PackedVertex>> packedVertices;
+        std::vector<std::vector<SkinnedVertex>> skinnedVertices;
+        std::vector<std::vector<MorphDelta>> morphDeltas;
+        std::vector<std::vector<uint32_t>> morphOffsets; // Per vertex, plus one past the last
+        std::vector<std::vector<uint32_t>> indices;
+    };
+
+    // Returns the future of filepath's load. When none is loaded or in
+    // flight, registers one and sets promise; the caller must then run
+    // RunLoad and fulfil it.
+    // A nonzero request is completed through the completion queue, at once
+    // if the model is already loaded.
+    std::shared_future<AssetLoadResult> FindOrStartLoad(const std::string& filepath,
+                                                        std::shared_ptr<std::promise<AssetLoadResult>>& promise,
+                                                        ModelRequestId request = 0);
+    void StartLoad(const std::string& filepath, const std::shared_ptr<std::promise<AssetLoadResult>>& promise);
+    AssetLoadResult RunLoad(const std::string& filepath);
+    void CompleteRequests(const std::string& filepath, const std::vector<ModelRequestId>& requests,
+                          const AssetLoadResult& result);
+    void StoreModel(const std::string& name, const ModelHandle& model, bool reloadable); // Caller holds m_modelsMutex
+    void RemoveModel(std::unordered_map<std::string, LoadedModel>::iterator it); // Caller holds m_modelsMutex
+
+    // glTF parsing methods; they cook the glTF into the form BuildModel uploads
     AssetLoadResult ParseGltfFile(const std::string& filepath);
-    bool LoadTextures(const tinygltf::Model& gltfModel, Model& model);
-    bool LoadMaterials(const tinygltf::Model& gltfModel, Model& model);
-    bool LoadMeshes(const tinygltf::Model& gltfModel, Model& model);
-    bool LoadNodes(const tinygltf::Model& gltfModel, Model& model);
+    bool DecodeCompressedBufferViews(tinygltf::Model& gltfModel, GltfBuffers& buffers, std::string& error);
+    bool LoadMaterials(const tinygltf::Model& gltfModel, const EncodedImages& encodedImages, CookedModel& cooked);
+    void LoadMeshes(const tinygltf::Model& gltfModel, const GltfBuffers& buffers, CookedModel& cooked,
+                    CookedGeometry& geometry, AssetTaskGroup& tasks);
+    void CookMesh(const tinygltf::Model& gltfModel, const GltfBuffers& buffers, size_t meshIndex, bool skinned,
+                  CookedMesh& mesh, CookedGeometry& geometry);
+    // nodeIndices maps glTF node indices to cooked ones, -1 for nodes outside the scene
+    void LoadNodes(const tinygltf::Model& gltfModel, CookedModel& cooked, std::vector<int32_t>& nodeIndices);
+    void LoadSkins(const tinygltf::Model& gltfModel, const GltfBuffers& buffers,
+                   const std::vector<int32_t>& nodeIndices, CookedModel& cooked);
+    void LoadAnimations(const tinygltf::Model& gltfModel, const GltfBuffers& buffers,
+                        const std::vector<int32_t>& nodeIndices, CookedModel& cooked);
+    bool LoadDependencies(const tinygltf::Model& gltfModel, const std::string& filepath, CookedModel& cooked);
+
+    // Creates and uploads GPU resources for a cooked model, freshly parsed or
+    // read from the mesh cache
+    bool BuildModel(const CookedModel& cooked, const std::vector<DecodedImage>& decodedImages,
+                    AssetLoadResult& result);
+    void DecodeImages(const CookedModel& cooked, std::vector<DecodedImage>& decodedImages, AssetTaskGroup& tasks);
+    bool LoadTextures(const CookedModel& cooked, Model& model, const std::vector<DecodedImage>& decodedImages,
+                      TransferBatch& batch);
+    void BuildNodes(const CookedModel& cooked, Model& model);
     
     // Helper methods
-    bool CreateTextureFromImage(const tinygltf::Image& image, Material& material);
+    // Null once shutting down, so tasks of late loads run inline
+    AssetThreadPool* GetTaskPool() const { return m_shutdown ? nullptr : m_threadPool.get(); }
+    void DestroyModelResources(Model& model);
+    void DestroyTexture(Texture& texture);
+    void MarkGeometryResident(const Model& model);
+    static bool KeepEncodedImage(tinygltf::Image* image, const int imageIndex, std::string* err, std::string* warn,
+                                 int reqWidth, int reqHeight, const unsigned char* bytes, int size, void* userData);
+    static DecodedImage DecodeImage(const CookedImage& image);
+    bool CreateTexture(const DecodedImage& image, const CookedTexture& source, Texture& texture,
+                       TransferBatch& batch);
+    bool SupportsSampledFormat(VkFormat format) const;
     bool CreateBufferFromAccessor(const tinygltf::Model& gltfModel, 
                                  const tinygltf::Accessor& accessor,
                                  VkBuffer& buffer, VmaAllocation& allocation);
     
     // Vertex processing
     void ProcessVertices(const tinygltf::Model& gltfModel, 
+                        const GltfBuffers& buffers,
                         const tinygltf::Primitive& primitive,
                         std::vector<Vertex>& vertices);
     
     void ProcessIndices(const tinygltf::Model& gltfModel,
+                       const GltfBuffers& buffers,
                        const tinygltf::Primitive& primitive,
                        std::vector<uint32_t>& indices);
 
+    // Pairs each vertex with its JOINTS_0 and WEIGHTS_0; vertices without
+    // them follow joint 0. Returns the highest joint index plus one.
+    uint32_t ProcessSkinWeights(const tinygltf::Model& gltfModel,
+                                const GltfBuffers& buffers,
+                                const tinygltf::Primitive& primitive,
+                                const std::vector<Vertex>& vertices,
+                                std::vector<SkinnedVertex>& skinnedVertices);
+
+    // Non-zero POSITION and NORMAL deltas of each vertex under each morph
+    // target, grouped by vertex: vertex v owns deltas[offsets[v]] up to
+    // deltas[offsets[v + 1]]. Returns the primitive's target count.
+    uint32_t ProcessMorphTargets(const tinygltf::Model& gltfModel,
+                                 const GltfBuffers& buffers,
+                                 const tinygltf::Primitive& primitive,
+                                 size_t vertexCount,
+                                 std::vector<MorphDelta>& deltas,
+                                 std::vector<uint32_t>& offsets);
+
     // Utility methods
     glm::mat4 GetNodeTransform(const tinygltf::Node& node);
     VkFormat GetVkFormat(int componentType, int type, bool normalized = false);
     VkPrimitiveTopology GetVkPrimitiveTopology(int mode);
-    std::unique_ptr<Node> LoadNode(const tinygltf::Model& gltfModel, const tinygltf::Node& gltfNode);
+    void LoadNode(const tinygltf::Model& gltfModel, int nodeIndex, int32_t parent, std::vector<CookedNode>& nodes,
+                  std::vector<int32_t>& nodeIndices);
 };
 
 } // namespace aero_boar
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace aero_boar {
+
+// Texture payload read from a KTX2 container, levels packed in order
+struct Ktx2Image {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+    std::vector<unsigned char> data;
+    std::vector<VkDeviceSize> levelOffsets; // Byte offset of each level in data
+};
+
+bool IsKtx2(const unsigned char* bytes, size_t size);
+
+// Reads 2D KTX2 textures stored directly in a Vulkan format (BC7, ASTC,
+// ETC2, RGBA8, ...). Every level must hold exactly the blocks its extent
+// needs. Basis Universal payloads (BasisLZ, UASTC) and zstd supercompression
+// need a transcoder this build does not have; they fail with an error.
+bool ReadKtx2(const unsigned char* bytes, size_t size, Ktx2Image& image, std::string& error);
+
+// sRGB or linear variant of a format, for formats that have both
+VkFormat GetColorSpaceVariant(VkFormat format, bool srgb);
+
+} // namespace aero_boar
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "assets/gltf_loader.hpp"
+#include "assets/mapped_file.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aero_boar {
+
+// Bump whenever the cooked layout or the loader's processing of vertices,
+// indices, materials, nodes, skins, morph targets or animations changes, so stale
+// entries are rebuilt
+constexpr uint32_t kCookedModelVersion = 7;
+
+// File besides the source whose contents the cooked model depends on
+// (.bin buffers and images of a .gltf)
+struct CookedDependency {
+    std::string path;
+    uint64_t hash = 0;
+};
+
+// Encoded image bytes (PNG, JPEG, KTX2), decoded at load time like the source's
+struct CookedImage {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    std::string name;
+};
+
+// Texture of a material slot: image, color space and glTF sampler state
+struct CookedTexture {
+    int32_t image = -1;
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    int32_t magFilter = -1;
+    int32_t minFilter = -1;
+    int32_t wrapS = TINYGLTF_TEXTURE_WRAP_REPEAT;
+    int32_t wrapT = TINYGLTF_TEXTURE_WRAP_REPEAT;
+};
+
+// GPU-ready geometry of all of a mesh's primitives, in the exact layout the
+// geometry arena of its vertex format uploads
+struct CookedMesh {
+    VertexFormat vertexFormat = VertexFormat::Float32;
+    glm::vec3 positionOffset = glm::vec3(0.0f); // Dequantization of packed positions
+    glm::vec3 positionScale = glm::vec3(1.0f);
+    const void* vertices = nullptr; // Vertex, PackedVertex or SkinnedVertex
+    uint32_t vertexCount = 0;
+    const uint32_t* indices = nullptr;
+    uint32_t indexCount = 0;
+    std::vector<Submesh> submeshes;
+    uint32_t jointCount = 0;
+    uint32_t morphTargetCount = 0;
+    const MorphDelta* morphDeltas = nullptr;
+    uint32_t morphDeltaCount = 0;
+    const uint32_t* morphOffsets = nullptr; // vertexCount + 1 entries when there are deltas
+    VertexCacheStats sourceCacheStats;
+    VertexCacheStats cacheStats;
+};
+
+// Node hierarchy in preorder, so parents always precede their children
+struct CookedNode {
+    int32_t parent = -1;
+    glm::mat4 transform = glm::mat4(1.0f);
+    NodePose restPose; // transform as animations drive it
+    std::vector<uint32_t> meshIndices;
+    int32_t skin = -1;
+    std::vector<float> morphWeights; // Rest weights of the mesh's morph targets
+    std::string name;
+};
+
+// A model as the loader uploads it. When read from the cache, the pointers
+// reference the mapped file and stay valid while it is open.
+struct CookedModel {
+    uint64_t sourceHash = 0;
+    std::vector<CookedDependency> dependencies;
+    std::vector<CookedImage> images;
+    std::vector<CookedTexture> textures;
+    std::vector<Material> materials;
+    std::vector<CookedMesh> meshes;
+    std::vector<CookedNode> nodes;
+    std::vector<Skin> skins;
+    std::vector<AnimationClip> animations;
+};
+
+// On-disk cache of cooked models keyed by the source file's content hash.
+// Entries use the native layout of the vertex formats and Material: the cache is a local
+// build artifact, not an interchange format.
+class MeshCache {
+public:
+    explicit MeshCache(const std::string& directory);
+
+    // FNV-1a, 64-bit
+    static uint64_t HashBytes(const unsigned char* data, size_t size);
+    static bool HashFile(const std::string& filepath, uint64_t& hash);
+
+    // Maps the entry for sourceHash. Fails on a miss, a version mismatch, a
+    // changed dependency or a truncated file.
+    bool Read(uint64_t sourceHash, MappedFile& file, CookedModel& model) const;
+
+    // Writes to a temporary file and renames it into place, so concurrent
+    // readers never observe a partial entry
+    bool Write(const CookedModel& model) const;
+
+private:
+    std::string m_directory;
+
+    std::string GetEntryPath(uint64_t sourceHash) const;
+};
+
+} // namespace aero_boar
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "assets/gltf_loader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aero_boar {
+
+// Post-transform cache entries assumed when ordering and measuring triangles
+constexpr uint32_t kVertexCacheSize = 16;
+
+// Cache behaviour of a triangle list, with a FIFO cache of kVertexCacheSize
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// Reorders the triangles of a triangle list for vertex cache hits (Tipsify),
+// then sorts the resulting clusters so outward-facing ones draw first,
+// reducing overdraw. Clusters are cut wherever the running miss ratio stays
+// within overdrawThreshold of the cache-optimal order, so larger thresholds
+// trade cache efficiency for finer overdraw sorting. Both optimizations
+// fail and leave their input untouched when an index is out of range.
+bool OptimizeTriangleOrder(uint32_t* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                           float overdrawThreshold = 1.05f);
+
+// Reorders vertices by first use so fetches walk the vertex buffer forward,
+// drops unreferenced vertices and rewrites the indices to match. Defined for
+// Vertex, and for uint32_t vertex ids to reorder data kept alongside them.
+template<typename VertexType>
+bool OptimizeVertexFetch(std::vector<VertexType>& vertices, uint32_t* indices, size_t indexCount);
+
+} // namespace aero_boar
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace aero_boar {
+
+// Encodings and filters of EXT_meshopt_compression buffer views
+enum class MeshoptMode {
+    Attributes, // Vertex codec
+    Triangles,  // Index codec, triangle lists
+    Indices,    // Index sequence codec
+};
+
+enum class MeshoptFilter {
+    None,
+    Octahedral,  // Normals and tangents, 4 x int8 or 4 x int16
+    Quaternion,  // Rotations, 4 x int16
+    Exponential, // Floats stored as 24-bit mantissa and 8-bit exponent
+};
+
+bool ParseMeshoptMode(const std::string& name, MeshoptMode& mode);
+bool ParseMeshoptFilter(const std::string& name, MeshoptFilter& filter);
+
+// Decodes one compressed buffer view into dst, which receives count elements
+// of stride bytes. Every read is bounds-checked, so malformed data fails
+// instead of overrunning the source.
+bool DecodeMeshoptBufferView(const unsigned char* source, size_t sourceSize, size_t count, size_t stride,
+                             MeshoptMode mode, MeshoptFilter filter, unsigned char* dst, std::string& error);
+
+} // namespace aero_boar
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "assets/gltf_loader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aero_boar {
+
+// Maps snorm16 positions back into the mesh bounds: offset + scale * snorm
+struct PositionQuantization {
+    glm::vec3 offset = glm::vec3(0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+uint32_t GetVertexStride(VertexFormat format);
+
+// Packs vertices when every attribute fits PackedVertex: quantized positions
+// stay within positionTolerance of the source, texture coordinates within
+// half-float precision and colors in [0, 1]. False leaves the mesh as Vertex.
+bool PackVertices(const Vertex* vertices, size_t count, float positionTolerance,
+                  std::vector<PackedVertex>& packed, PositionQuantization& quantization);
+
+} // namespace aero_boar
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace aero_boar {
+
+class TransferBatch;
+class TransferManager;
+
+// Meshes keep a handle instead of offsets because compaction moves their data
+using GeometryHandle = uint32_t;
+constexpr GeometryHandle kInvalidGeometryHandle = 0;
+
+// Where a mesh currently lives in the arena, in elements rather than bytes,
+// ready to pass to vkCmdDrawIndexed
+struct GeometryRange {
+    int32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+struct GeometryArenaConfig {
+    VkDeviceSize vertexCapacity = 128ull * 1024 * 1024;
+    VkDeviceSize indexCapacity = 64ull * 1024 * 1024;
+    // Compact once this fraction of the arena is free but split into holes
+    float compactionThreshold = 0.25f;
+    // Added to the buffers' usage, e.g. STORAGE for arenas read by compute
+    VkBufferUsageFlags vertexUsage = 0;
+    VkBufferUsageFlags indexUsage = 0;
+};
+
+// Sub-allocates static mesh data out of one device-local vertex buffer and one
+// index buffer, so a whole scene draws with a single bind. Freed ranges are
+// recycled once the frames that may still read them have retired.
+class GeometryArena {
+public:
+    GeometryArena(VkDevice device, VmaAllocator allocator, TransferManager& transferManager,
+                  uint32_t vertexStride, uint32_t framesInFlight,
+                  const GeometryArenaConfig& config = GeometryArenaConfig{});
+    ~GeometryArena();
+
+    bool Initialize();
+    void Shutdown();
+
+    // Reserves space and adds the copies to batch. The data must stay valid
+    // until the batch is committed. Call MarkResident once the batch retires.
+    GeometryHandle Allocate(const void* vertices, uint32_t vertexCount,
+                            const uint32_t* indices, uint32_t indexCount, TransferBatch& batch);
+    void MarkResident(GeometryHandle handle);
+    void Free(GeometryHandle handle);
+
+    bool GetRange(GeometryHandle handle, GeometryRange& range) const;
+
+    // Render thread, once per frame after the frame's fence has been waited on
+    void BeginFrame();
+
+    // Packs live ranges into fresh buffers when fragmentation warrants it and
+    // no upload into the arena is outstanding. Must be recorded outside a
+    // render pass, after the frame's ownership acquires.
+    bool RecordCompaction(VkCommandBuffer commandBuffer);
+
+    void Bind(VkCommandBuffer commandBuffer) const;
+    void BindIndexBuffer(VkCommandBuffer commandBuffer) const;
+    // Change when compaction swaps buffers; read them after RecordCompaction
+    VkBuffer GetVertexBuffer() const;
+    VkBuffer GetIndexBuffer() const;
+
+private:
+    // Offset-ordered free blocks, coalesced on free. Units are elements.
+    class FreeList {
+    public:
+        void Reset(uint64_t capacity);
+        bool Allocate(uint64_t count, uint64_t& offset);
+        void Free(uint64_t offset, uint64_t count);
+        uint64_t GetFreeCount() const { return m_freeCount; }
+        uint64_t GetLargestBlock() const;
+
+    private:
+        std::map<uint64_t, uint64_t> m_blocks; // offset -> count
+        uint64_t m_freeCount = 0;
+    };
+
+    struct Allocation {
+        uint64_t vertexOffset = 0;
+        uint64_t vertexCount = 0;
+        uint64_t firstIndex = 0;
+        uint64_t indexCount = 0;
+        bool live = false;
+        bool resident = false; // Upload has retired
+    };
+
+    struct PendingFree {
+        GeometryHandle handle = kInvalidGeometryHandle;
+        uint32_t framesLeft = 0;
+    };
+
+    struct RetiredBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        uint32_t framesLeft = 0;
+    };
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    TransferManager& m_transferManager;
+    uint32_t m_vertexStride = 0;
+    uint32_t m_framesInFlight = 0;
+    GeometryArenaConfig m_config;
+
+    VkBuffer m_vertexBuffer = VK_NULL_HANDLE;
+    VmaAllocation m_vertexAllocation = VK_NULL_HANDLE;
+    VkBuffer m_indexBuffer = VK_NULL_HANDLE;
+    VmaAllocation m_indexAllocation = VK_NULL_HANDLE;
+    uint64_t m_vertexCapacity = 0; // In vertices
+    uint64_t m_indexCapacity = 0;  // In indices
+
+    FreeList m_vertexFreeList;
+    FreeList m_indexFreeList;
+    std::vector<Allocation> m_allocations; // Indexed by handle - 1
+    std::vector<GeometryHandle> m_freeHandles;
+    std::vector<PendingFree> m_pendingFrees;
+    std::vector<RetiredBuffer> m_retiredBuffers;
+    uint32_t m_uploadsInFlight = 0;
+    bool m_compactionRequested = false;
+    mutable std::mutex m_mutex;
+
+    bool CreateBuffers(VkBuffer& vertexBuffer, VmaAllocation& vertexAllocation,
+                       VkBuffer& indexBuffer, VmaAllocation& indexAllocation);
+    void ReleaseRanges(Allocation& allocation);
+    bool IsFragmented() const;
+};
+
+} // namespace aero_boar
@@ -7,6 +7,7 @@
 #include <vk_mem_alloc.h>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -14,11 +15,23 @@ namespace aero_boar {
 
 // Forward declarations
 class GltfLoader;
+class ResidencyManager;
+class SkinningSystem;
 class InputManager;
 class IWindow;
 struct Model;
 struct Mesh;
 struct Vertex;
+struct ModelLoadCompletion;
+enum class VertexFormat : uint32_t;
+using ModelRequestId = uint64_t; // As in gltf_loader.hpp
+using AnimatedInstanceId = uint32_t; // As in skinning_system.hpp
+
+enum class ModelRequestStatus {
+    Unknown, // Not an id RequestModel returned, failed, or released
+    Pending, // Loading, or waiting for its uploads to retire
+    Ready,   // Published to the scene
+};
 
 class Renderer {
 public:
@@ -37,11 +50,22 @@ public:
     // Window resize handling
     void OnWindowResize();
 
-    // Asset loading
-    bool LoadModel(const std::string& filepath);
+    // Asset loading. RequestModel returns at once; the model joins the scene
+    // in a later BeginFrame, once loaded and uploaded.
+    ModelRequestId RequestModel(const std::string& filepath);
+    ModelRequestStatus GetModelRequestStatus(ModelRequestId request) const;
+    // Drops the handle a Ready request holds; its id reads Unknown afterwards
+    void ReleaseModel(ModelRequestId request);
     bool CreateCubeModel();
     void RenderModel(const std::string& modelName);
 
+    // Animated instances of a loaded skinned model, posed by the skinning
+    // pass each frame. Returns 0 when the model is not loaded.
+    AnimatedInstanceId CreateAnimatedInstance(const std::string& modelName, const glm::mat4& transform,
+                                              uint32_t clip = 0);
+    void DestroyAnimatedInstance(AnimatedInstanceId id);
+    void UpdateAnimations(float deltaTime);
+
     // Camera controls
     void UpdateCamera(float deltaTime);
     void ResetCamera();
@@ -63,12 +87,29 @@ private:
     VkDevice m_device = VK_NULL_HANDLE;
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
+    uint32_t m_graphicsQueueFamilyIndex = 0;
+
+    // Async queues; alias the graphics queue when the device has no separate family
+    VkQueue m_transferQueue = VK_NULL_HANDLE;
+    uint32_t m_transferQueueFamilyIndex = 0;
+    VkQueue m_computeQueue = VK_NULL_HANDLE;
+    uint32_t m_computeQueueFamilyIndex = 0;
+
+    // Guards submissions to the graphics queue when the transfer queue aliases it
+    std::mutex m_queueSubmitMutex;
     
     // VMA allocator
     VmaAllocator m_allocator = VK_NULL_HANDLE;
 
     // Asset loading
     std::unique_ptr<GltfLoader> m_gltfLoader;
+    std::vector<std::shared_ptr<Model>> m_modelHandles; // Models created without a request
+    std::vector<ModelLoadCompletion> m_completedLoads;   // Loaded, uploads still in flight
+    // Pending requests map to null, Ready ones to their handle; failed loads
+    // and released handles leave the map
+    std::unordered_map<ModelRequestId, std::shared_ptr<Model>> m_modelRequests;
+    std::unique_ptr<ResidencyManager> m_residencyManager;
+    std::unique_ptr<SkinningSystem> m_skinningSystem;
     
     // Input management
     std::unique_ptr<InputManager> m_inputManager;
@@ -88,6 +129,7 @@ private:
     VkRenderPass m_renderPass = VK_NULL_HANDLE;
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
     VkPipeline m_graphicsPipeline = VK_NULL_HANDLE;
+    VkPipeline m_packedGraphicsPipeline = VK_NULL_HANDLE; // PackedVertex input, pbr_packed.vert
 
     // Framebuffers
     std::vector<VkFramebuffer> m_swapchainFramebuffers;
@@ -117,9 +159,13 @@ private:
     uint32_t m_currentImageIndex = 0;
     static const int MAX_FRAMES_IN_FLIGHT = 2;
 
+    // Transfer timeline value the current frame must wait on before drawing
+    uint64_t m_transferWaitValue = 0;
+
 
     // State
     bool m_initialized = false;
+    bool m_memoryBudgetSupported = false; // VK_EXT_memory_budget, for real VMA heap budgets
     bool m_framebufferResized = false;
     bool m_frameSkipped = false;
 
@@ -128,6 +174,7 @@ private:
     bool CreateSurface();
     bool SelectPhysicalDevice();
     bool CreateLogicalDevice();
+    void SelectAsyncQueue(vkb::QueueType type, VkQueue& queue, uint32_t& familyIndex);
     bool CreateVMAAllocator();
     bool CreateSwapchain();
     bool CreateImageViews();
@@ -141,6 +188,7 @@ private:
 
     void CleanupSwapchain();
     void RecreateSwapchain();
+    void PublishCompletedLoads();
     
     // Frame management methods
     void WaitForActiveFrames();
@@ -180,6 +228,12 @@ private:
         glm::mat4 view;
         glm::mat4 proj;
     };
+
+    // Dequantization of packed positions, pushed per mesh for the packed pipeline
+    struct PackedMeshConstants {
+        glm::vec4 positionOffset;
+        glm::vec4 positionScale;
+    };
     
     VkBuffer m_uniformBuffer = VK_NULL_HANDLE;
     VmaAllocation m_uniformBufferAllocation = VK_NULL_HANDLE;
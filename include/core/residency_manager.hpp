@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace aero_boar {
+
+class GltfLoader;
+
+struct ResidencyConfig {
+    // Fraction of the device-local heap budget VMA reports that the engine
+    // may use before models are evicted
+    float budgetFraction = 0.8f;
+    // Models rendered within this many frames are never evicted; at least the
+    // frames in flight, whose command buffers may still read them
+    uint32_t minIdleFrames = 120;
+
+    static ResidencyConfig LoadFromFile(const std::string& filepath);
+};
+
+struct ResidencyStats {
+    VkDeviceSize heapUsage = 0;  // Device-local usage of the whole process, from VMA
+    VkDeviceSize heapBudget = 0; // Device-local budget, from VMA
+    VkDeviceSize modelBytes = 0;   // Held by resident models
+    VkDeviceSize textureBytes = 0; // Part of modelBytes that eviction returns to the heap
+    uint32_t evictedThisFrame = 0;
+};
+
+// Keeps device-local memory use under the budget VMA reports by evicting the
+// least recently rendered models, and brings evicted models back through
+// asynchronous reloads once they are rendered again. Only texture memory
+// counts as reclaimable: geometry arenas are preallocated, so evicting
+// geometry frees arena space but never lowers the heap usage.
+class ResidencyManager {
+public:
+    ResidencyManager(VmaAllocator allocator, GltfLoader& loader, uint32_t framesInFlight,
+                     const ResidencyConfig& config = ResidencyConfig{});
+
+    // Reads the heap budgets and evicts while over budget; call once per frame
+    // on the render thread, after GltfLoader::UpdatePendingUploads
+    void Update();
+
+    // Records that a model is drawn this frame. Returns false while it is
+    // evicted, after queueing its reload.
+    bool RequestResident(const std::string& name);
+
+    const ResidencyStats& GetStats() const { return m_stats; }
+
+private:
+    VmaAllocator m_allocator;
+    GltfLoader& m_loader;
+    ResidencyConfig m_config;
+    uint32_t m_framesInFlight;
+    uint32_t m_frameIndex = 0;
+    ResidencyStats m_stats;
+    bool m_reportedUnreachable = false; // Budget below what eviction can reach
+
+    std::unordered_map<std::string, uint32_t> m_lastRenderedFrame;
+};
+
+} // namespace aero_boar
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace aero_boar {
+
+class GltfLoader;
+class ResidencyManager;
+class AssetThreadPool;
+class AssetTaskGroup;
+struct Model;
+
+// Instances keep a handle so destroying one never shifts the others
+using AnimatedInstanceId = uint32_t;
+constexpr AnimatedInstanceId kInvalidAnimatedInstance = 0;
+
+// Plays skeletal and morph target animations on instances of skinned models.
+// Joint palettes and morph weights of all instances are evaluated in parallel
+// on worker threads while the frame is set up; one compute dispatch then
+// blends and skins every instance's meshes into a shared vertex buffer that
+// draws with the regular Vertex pipeline.
+class SkinningSystem {
+public:
+    SkinningSystem(VkDevice device, VmaAllocator allocator, GltfLoader& loader,
+                   ResidencyManager* residencyManager, uint32_t framesInFlight);
+    ~SkinningSystem();
+
+    bool Initialize(const std::vector<char>& computeShaderCode);
+    void Shutdown();
+
+    // Plays the model's clip from the start, looping; the transform places
+    // the instance in world space
+    AnimatedInstanceId CreateInstance(std::shared_ptr<Model> model, const glm::mat4& transform, uint32_t clip = 0);
+    void DestroyInstance(AnimatedInstanceId id);
+    void SetTransform(AnimatedInstanceId id, const glm::mat4& transform);
+
+    // Advances the clip time of every instance
+    void Update(float deltaTime);
+
+    // Render thread, once per frame after the frame's fence has been waited on
+    // and the loader's per-frame updates: starts evaluating joint palettes and
+    // morph weights
+    void BeginFrame(uint32_t frameIndex);
+
+    // Waits for the evaluation and records the skinning dispatch. Must be
+    // recorded outside a render pass, after the geometry arenas' compaction.
+    void RecordSkinning(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    // Draws the skinned vertices inside the render pass; the bound pipeline
+    // must take Vertex input
+    void RecordDraws(VkCommandBuffer commandBuffer) const;
+
+private:
+    struct Instance {
+        std::shared_ptr<Model> model;
+        glm::mat4 transform = glm::mat4(1.0f);
+        uint32_t clip = 0;
+        float time = 0.0f;
+    };
+
+    // An instance as this frame's evaluation sees it, so instances can change
+    // while the worker threads run
+    struct Evaluation {
+        std::shared_ptr<Model> model;
+        glm::mat4 transform = glm::mat4(1.0f);
+        uint32_t clip = 0;
+        float time = 0.0f;
+        uint32_t firstJoint = 0;       // Into the frame's palette buffer
+        uint32_t firstMorphWeight = 0; // Into the frame's morph weight buffer
+    };
+
+    // Matches the Job struct in skinning.comp
+    struct SkinningJob {
+        uint32_t sourceVertex = 0;     // In the skinned geometry arena
+        uint32_t firstJoint = 0;       // In the frame's palette buffer
+        uint32_t firstThread = 0;      // Also the job's first vertex in the output buffer
+        uint32_t morphOffsets = 0;     // In the morph arena's indices, or kNoMorphTargets
+        uint32_t morphDeltas = 0;      // In the morph arena's vertices
+        uint32_t firstMorphWeight = 0; // In the frame's morph weight buffer
+    };
+
+    struct DrawCommand {
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+    };
+
+    struct HostBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+        VkDeviceSize size = 0;
+    };
+
+    struct FrameResources {
+        HostBuffer palettes;     // glm::mat4 per joint
+        HostBuffer morphWeights; // float per morph target of each skinned mesh
+        HostBuffer jobs;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    };
+
+    struct RetiredBuffer {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        uint32_t framesLeft = 0;
+    };
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    GltfLoader& m_loader;
+    ResidencyManager* m_residencyManager = nullptr;
+    uint32_t m_framesInFlight = 0;
+
+    VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    std::vector<FrameResources> m_frames;
+
+    // Posed vertices of every instance, rewritten each frame
+    VkBuffer m_outputBuffer = VK_NULL_HANDLE;
+    VmaAllocation m_outputAllocation = VK_NULL_HANDLE;
+    uint64_t m_outputCapacity = 0; // In vertices
+    std::vector<RetiredBuffer> m_retiredBuffers;
+
+    std::vector<Instance> m_instances; // Indexed by id - 1; freed ones have no model
+    std::vector<AnimatedInstanceId> m_freeIds;
+
+    std::unique_ptr<AssetThreadPool> m_threadPool;
+    std::unique_ptr<AssetTaskGroup> m_evaluationTasks;
+    std::vector<Evaluation> m_evaluations;
+    std::unordered_map<const Model*, bool> m_residentModels; // This frame's residency requests
+    std::vector<SkinningJob> m_jobs;
+    std::vector<DrawCommand> m_draws;
+
+    bool CreatePipeline(const std::vector<char>& computeShaderCode);
+    bool ReserveHostBuffer(HostBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage);
+    bool ReserveOutput(uint64_t vertexCount);
+    void DestroyHostBuffer(HostBuffer& buffer);
+    void WaitForEvaluation();
+    void EvaluateInstances(size_t first, size_t count, glm::mat4* palettes, float* morphWeights) const;
+};
+
+} // namespace aero_boar
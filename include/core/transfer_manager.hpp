@@ -2,14 +2,161 @@
 
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace aero_boar {
 
+// Handle to committed transfers. A batch only gets its point on the transfer
+// timeline when the submit point actually submits it, so the ticket shares
+// that value with the manager (0 while still queued). An empty ticket means
+// there is nothing to wait on.
+class TransferTicket {
+public:
+    bool IsValid() const { return !m_batches.empty(); }
+
+    // Fold another ticket into this one
+    void Include(const TransferTicket& other) {
+        m_batches.insert(m_batches.end(), other.m_batches.begin(), other.m_batches.end());
+    }
+
+private:
+    friend class TransferManager;
+    std::vector<std::shared_ptr<std::atomic<uint64_t>>> m_batches;
+};
+
+// Order in which queued batches are submitted when the frame budget is tight
+enum class TransferPriority {
+    Critical,    // Needed now; always submitted regardless of budget
+    VisibleSoon, // About to be drawn
+    Background,  // Prefetch and streaming
+    Count
+};
+
+// Upload path tunables, read from config/transfer.json
+struct TransferConfig {
+    // Size of the persistently mapped staging ring all uploads sub-allocate from
+    VkDeviceSize stagingRingSize = 64ull * 1024 * 1024;
+
+    // Bytes of non-critical uploads submitted per frame; 0 means unlimited
+    VkDeviceSize frameUploadBudget = 8ull * 1024 * 1024;
+
+    // Period of the stats log line and CSV row; 0 disables both
+    float statsIntervalSeconds = 0.0f;
+
+    // CSV file stats rows are appended to; empty logs to stdout only
+    std::string statsCsvPath;
+
+    static TransferConfig LoadFromFile(const std::string& filepath);
+};
+
+// Queue selected for uploads at device creation. Prefers a dedicated
+// transfer (DMA) family; falls back to sharing the graphics queue.
+struct TransferQueueInfo {
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t familyIndex = UINT32_MAX;
+    uint32_t graphicsFamilyIndex = UINT32_MAX;
+
+    // Set when the queue is shared with the renderer; every submission to it
+    // must hold this mutex (Vulkan queues are externally synchronized)
+    std::mutex* submitMutex = nullptr;
+};
+
+// Copies for one asset, committed together: one staging region, one command
+// buffer and a single timeline signal. Source data is read at commit time,
+// so it must stay valid until TransferManager::CommitBatch returns.
+class TransferBatch {
+public:
+    void AddBufferCopy(VkBuffer buffer, VmaAllocation allocation, const void* data, size_t dataSize,
+                       VkDeviceSize dstOffset = 0);
+    // levelOffsets[i] is the byte offset of mip i within data, all array
+    // layers of a level packed together; empty means only level 0 at offset 0.
+    // With generateMips, levels past the provided ones are blitted on the GPU.
+    void AddImageCopy(VkImage image, const VkImageCreateInfo& imageInfo, const void* data, size_t dataSize,
+                      const std::vector<VkDeviceSize>& levelOffsets = {}, bool generateMips = false);
+
+    bool IsEmpty() const { return m_bufferCopies.empty() && m_imageCopies.empty(); }
+    TransferPriority GetPriority() const { return m_priority; }
+
+private:
+    friend class TransferManager;
+
+    struct BufferCopy {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        const void* data = nullptr;
+        VkDeviceSize size = 0;
+        VkDeviceSize dstOffset = 0;
+    };
+
+    struct ImageCopy {
+        VkImage image = VK_NULL_HANDLE;
+        VkExtent3D extent = {};
+        uint32_t mipLevels = 1;
+        uint32_t arrayLayers = 1;
+        const void* data = nullptr;
+        VkDeviceSize size = 0;
+        std::vector<VkDeviceSize> levelOffsets;
+        bool generateMips = false;
+    };
+
+    std::vector<BufferCopy> m_bufferCopies;
+    std::vector<ImageCopy> m_imageCopies;
+    TransferPriority m_priority = TransferPriority::VisibleSoon;
+};
+
+// Uploads committed but not yet submitted, per priority
+struct TransferBacklog {
+    uint32_t batches[static_cast<size_t>(TransferPriority::Count)] = {};
+    VkDeviceSize bytes[static_cast<size_t>(TransferPriority::Count)] = {};
+};
+
+// Upload path counters, see TransferManager::GetStats. Latencies are bucketed
+// by upper bound in milliseconds; the last bucket takes everything above.
+struct TransferStats {
+    static constexpr size_t kLatencyBuckets = 8;
+    static constexpr double kLatencyBucketLimitsMs[kLatencyBuckets - 1] = {0.5, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0};
+
+    uint64_t totalBytes = 0;          // Staged and directly written bytes since start
+    uint64_t totalBatches = 0;        // Batches submitted to the transfer queue
+    VkDeviceSize frameBytes = 0;      // Bytes uploaded during the last frame
+    double bytesPerSecond = 0.0;      // Over the last stats window (about a second)
+
+    uint32_t queuedBatches = 0;       // Waiting for the submit point
+    uint32_t inFlightBatches = 0;     // Submitted, not yet retired
+
+    VkDeviceSize stagingSize = 0;
+    VkDeviceSize stagingUsed = 0;
+    VkDeviceSize stagingHighWater = 0;
+
+    // Host submit to retirement, as seen by CollectCompleted (frame granular)
+    uint64_t submitLatency[kLatencyBuckets] = {};
+    double maxSubmitLatencyMs = 0.0;
+
+    // Execution time on the transfer queue from GPU timestamps; empty when the
+    // queue family has no timestamp support
+    uint64_t gpuTime[kLatencyBuckets] = {};
+    double maxGpuTimeMs = 0.0;
+
+    double waitStallMs = 0.0;         // Blocked in Wait
+    double stagingStallMs = 0.0;      // Blocked on a full staging ring
+
+    static size_t GetLatencyBucket(double milliseconds);
+};
+
 // Transfer manager for Vulkan transfer operations
 class TransferManager {
 public:
-    TransferManager(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator);
+    TransferManager(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator,
+                    const TransferQueueInfo& queueInfo, const TransferConfig& config = TransferConfig{});
     ~TransferManager();
 
     bool Initialize();
@@ -18,37 +165,235 @@ public:
     // Buffer operations
     bool CreateBuffer(VkBufferCreateInfo& bufferInfo, VmaAllocationCreateInfo& allocInfo,
                      VkBuffer& buffer, VmaAllocation& allocation);
-    
-    bool UploadBufferData(VkBuffer buffer, VmaAllocation allocation, 
+
+    // Creates a buffer for static GPU data (geometry). Device-local on discrete
+    // GPUs; host-visible device memory on unified-memory devices so uploads can
+    // be written directly.
+    bool CreateStaticBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                            VkBuffer& buffer, VmaAllocation& allocation);
+
+    // Writes host-visible allocations directly and returns an empty ticket;
+    // otherwise stages the data and copies it on the transfer queue.
+    TransferTicket UploadBufferDataAsync(VkBuffer buffer, VmaAllocation allocation,
+                                         const void* data, size_t dataSize, VkDeviceSize dstOffset = 0);
+
+    bool UploadBufferData(VkBuffer buffer, VmaAllocation allocation,
                          const void* data, size_t dataSize);
-    
+
     // Image operations
     bool CreateImage(VkImageCreateInfo& imageInfo, VmaAllocationCreateInfo& allocInfo,
                     VkImage& image, VmaAllocation& allocation);
-    
+
+    // Records and submits the copy without waiting for the GPU. The source data
+    // is consumed before returning; the image is usable once the ticket retires.
+    TransferTicket UploadImageDataAsync(VkImage image, const VkImageCreateInfo& imageInfo,
+                                        const void* data, size_t dataSize);
+
+    // Blocking variant, equivalent to UploadImageDataAsync followed by Wait
     bool UploadImageData(VkImage image, VkImageCreateInfo& imageInfo,
                         const void* data, size_t dataSize);
 
+    // Whether missing mip levels of this format can be generated with blits
+    bool SupportsMipGeneration(VkFormat format) const;
+    static uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+
+    // Batched uploads. CommitBatch writes host-visible destinations directly
+    // and submits everything else at once; the ticket stays empty when no GPU
+    // work was needed. The batch is empty again afterwards.
+    TransferBatch BeginBatch(TransferPriority priority = TransferPriority::VisibleSoon) const;
+    bool CommitBatch(TransferBatch& batch, TransferTicket& ticket);
+
+    // Ticket queries. Waiting on a ticket that is still queued for the submit
+    // point flushes it first.
+    bool IsComplete(const TransferTicket& ticket) const;
+    bool Wait(const TransferTicket& ticket, uint64_t timeoutNs = UINT64_MAX);
+    uint64_t GetCompletedValue() const;
+
+    // Per-frame submit point: submits queued batches in priority order until
+    // the frame upload budget is spent, in one vkQueueSubmit. Call once per frame.
+    void FlushSubmissions();
+
+    TransferBacklog GetBacklog() const;
+    TransferStats GetStats() const;
+
+    // Release command buffers and staging memory of retired submissions
+    void CollectCompleted();
+
+    // Records the graphics-queue half of pending queue family ownership
+    // transfers. Must be recorded outside a render pass; returns the timeline
+    // value the command buffer's submission has to wait on.
+    // Also builds mip chains the transfer queue could not blit, so the wait
+    // on the returned value has to cover kAcquireStages.
+    uint64_t RecordOwnershipAcquires(VkCommandBuffer graphicsCommandBuffer);
+    static constexpr VkPipelineStageFlags kAcquireStages =
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    bool IsUnifiedMemory() const { return m_unifiedMemory; }
     VkQueue GetTransferQueue() const { return m_transferQueue; }
-    VkCommandPool GetCommandPool() const { return m_commandPool; }
+    uint32_t GetTransferQueueFamilyIndex() const { return m_transferQueueFamilyIndex; }
+    VkSemaphore GetTimelineSemaphore() const { return m_timelineSemaphore; }
 
 private:
+    // Upload space handed out by the staging ring. Requests larger than the
+    // whole ring fall back to a dedicated buffer that is freed on retirement.
+    struct StagingRegion {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        void* mapped = nullptr;
+        uint64_t ringBlock = 0; // Sequence number of the ring block, 0 if not from the ring
+        VmaAllocation dedicatedAllocation = VK_NULL_HANDLE;
+    };
+
+    // Span of the ring taken by one region. Blocks go back to the ring in
+    // allocation order, even when their submissions retire out of order.
+    struct RingBlock {
+        VkDeviceSize end = 0;      // Ring tail position once this block is returned
+        VkDeviceSize consumed = 0; // Bytes taken from the ring, including wrap padding
+        bool released = false;
+    };
+
+    // Command pool owned by one recording thread. Only that thread allocates,
+    // resets or begins its command buffers; retired ones come back via `retired`.
+    struct ThreadContext {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> freeCommandBuffers;
+        std::vector<VkCommandBuffer> retired;
+        std::mutex retiredMutex;
+    };
+
+    // Graphics-side half of an ownership transfer released by the transfer queue
+    struct PendingAcquire {
+        // Mip chain left for the graphics queue to blit after the acquire
+        struct MipGeneration {
+            VkImage image = VK_NULL_HANDLE;
+            VkExtent3D extent = {};
+            uint32_t mipLevels = 1;
+            uint32_t arrayLayers = 1;
+        };
+
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        std::vector<MipGeneration> mipGenerations;
+        uint64_t timelineValue = 0;
+    };
+
+    // Recorded batch waiting for the submit point. Producers push onto a
+    // lock-free intrusive stack that FlushSubmissions drains.
+    struct PendingSubmission {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        ThreadContext* context = nullptr;
+        StagingRegion staging;
+        PendingAcquire acquire;
+        std::shared_ptr<std::atomic<uint64_t>> timelineValue; // Shared with the ticket
+        VkDeviceSize bytes = 0;
+        TransferPriority priority = TransferPriority::VisibleSoon;
+        uint32_t timestampSlot = UINT32_MAX; // Query pair bracketing the command buffer
+        PendingSubmission* next = nullptr;
+    };
+
+    // Work that has been submitted but may still be executing on the GPU
+    struct InFlightSubmission {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        ThreadContext* context = nullptr;
+        StagingRegion staging;
+        uint64_t timelineValue = 0;
+        uint32_t timestampSlot = UINT32_MAX;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
     VkDevice m_device = VK_NULL_HANDLE;
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
     VmaAllocator m_allocator = VK_NULL_HANDLE;
+    TransferConfig m_config;
+    TransferQueueInfo m_queueInfo;
+    uint64_t m_instanceId = 0;
     VkQueue m_transferQueue = VK_NULL_HANDLE;
-    VkCommandPool m_commandPool = VK_NULL_HANDLE;
-    VkCommandBuffer m_commandBuffer = VK_NULL_HANDLE;
-    VkFence m_fence = VK_NULL_HANDLE;
-    std::mutex m_mutex;
+    uint32_t m_transferQueueFamilyIndex = UINT32_MAX;
+    uint32_t m_graphicsQueueFamilyIndex = UINT32_MAX;
+    bool m_unifiedMemory = false;
+    bool m_transferSupportsBlit = false; // Transfer family has graphics capability
+    VkSemaphore m_timelineSemaphore = VK_NULL_HANDLE;
+
+    // Per-thread recording contexts
+    std::vector<std::unique_ptr<ThreadContext>> m_threadContexts;
+    std::mutex m_contextMutex;
+
+    // Submission. Timeline values are handed out by the submit point, so
+    // batches can be held back or reordered by priority.
+    static constexpr size_t kPriorityCount = static_cast<size_t>(TransferPriority::Count);
+    std::atomic<uint64_t> m_lastSubmittedValue{0};
+    std::atomic<PendingSubmission*> m_pendingHead{nullptr};
+    std::deque<PendingSubmission*> m_queuedSubmissions[kPriorityCount]; // Guarded by m_submitMutex
+    std::atomic<uint32_t> m_queuedBatches[kPriorityCount] = {};
+    std::atomic<VkDeviceSize> m_queuedBytes[kPriorityCount] = {};
+    std::mutex m_submitMutex;
+
+    std::deque<InFlightSubmission> m_inFlight;
+    mutable std::mutex m_inFlightMutex;
+
+    // Ownership acquires waiting for the renderer
+    std::vector<PendingAcquire> m_pendingAcquires;
+    std::mutex m_acquireMutex;
+
+    // Staging ring
+    VkBuffer m_stagingBuffer = VK_NULL_HANDLE;
+    VmaAllocation m_stagingAllocation = VK_NULL_HANDLE;
+    uint8_t* m_stagingMapped = nullptr;
+    VkDeviceSize m_stagingSize = 0;
+    VkDeviceSize m_stagingAlignment = 16;
+    VkDeviceSize m_stagingHead = 0;
+    VkDeviceSize m_stagingTail = 0;
+    VkDeviceSize m_stagingUsed = 0;
+    std::deque<RingBlock> m_ringBlocks;
+    uint64_t m_firstRingBlock = 1; // Sequence number of m_ringBlocks.front()
+    mutable std::mutex m_stagingMutex;
+
+    // GPU timestamps, one query pair per submission
+    static constexpr uint32_t kTimestampSlots = 256;
+    VkQueryPool m_timestampPool = VK_NULL_HANDLE;
+    float m_timestampPeriod = 1.0f; // Nanoseconds per tick
+    uint64_t m_timestampMask = 0;
+    std::vector<uint32_t> m_freeTimestampSlots;
+    std::mutex m_timestampMutex;
+
+    // Stats. m_statsMutex is always the innermost lock.
+    TransferStats m_stats;
+    VkDeviceSize m_frameBytes = 0;
+    VkDeviceSize m_windowBytes = 0;
+    std::chrono::steady_clock::time_point m_windowStart;
+    std::chrono::steady_clock::time_point m_lastStatsOutput;
+    std::ofstream m_statsCsv;
+    mutable std::mutex m_statsMutex;
 
     bool CreateTransferQueue();
-    bool CreateCommandPool();
-    bool CreateCommandBuffer();
-    bool CreateFence();
-    bool SubmitCommandBuffer();
-    void WaitForCompletion();
+    bool CreateTimelineSemaphore();
+    bool CreateStagingRing();
+    void DetectUnifiedMemory();
+    void CreateTimestampQueries();
+    uint32_t AcquireTimestampSlot();
+    void ReleaseTimestampSlot(uint32_t slot);
+    void RecordRetirement(const InFlightSubmission& submission, std::chrono::steady_clock::time_point now);
+    void AddUploadedBytes(VkDeviceSize bytes);
+    void UpdateFrameStats();
+    void OutputStats(const TransferStats& stats);
+    bool NeedsOwnershipTransfer() const { return m_transferQueueFamilyIndex != m_graphicsQueueFamilyIndex; }
+    ThreadContext* GetThreadContext();
+    VkCommandBuffer BeginCommandBuffer(ThreadContext& context);
+    bool WriteBufferDirect(const TransferBatch::BufferCopy& copy);
+    bool AllocateStaging(VkDeviceSize size, StagingRegion& region);
+    bool TryAllocateFromRing(VkDeviceSize size, StagingRegion& region);
+    void FlushStaging(const StagingRegion& region, VkDeviceSize size);
+    void ReleaseStaging(const StagingRegion& region);
+    TransferTicket EnqueueSubmission(VkCommandBuffer commandBuffer, ThreadContext& context,
+                                     const StagingRegion& staging, PendingAcquire acquire,
+                                     VkDeviceSize bytes, TransferPriority priority, uint32_t timestampSlot);
+    void SubmitQueued(VkDeviceSize byteBudget, size_t minBatches, const std::atomic<uint64_t>* requiredBatch);
+    void QueueAcquire(PendingAcquire acquire);
+    static void RecordMipChain(VkCommandBuffer commandBuffer, VkImage image, VkExtent3D extent,
+                               uint32_t mipLevels, uint32_t arrayLayers);
+    static void AppendShaderReadBarriers(VkImage image, uint32_t mipLevels, uint32_t arrayLayers,
+                                         bool mipsGenerated, std::vector<VkImageMemoryBarrier>& barriers);
 };
 
 } // namespace aero_boar
-
@@ -0,0 +1,38 @@
+#version 450
+
+// PackedVertex input; outputs match pbr.vert
+layout(location = 0) in vec4 inPosition;  // snorm16 within the mesh bounds
+layout(location = 1) in vec2 inNormal;    // Octahedral snorm16
+layout(location = 2) in vec2 inTexCoord;  // Half float
+layout(location = 3) in vec4 inColor;     // unorm8
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(push_constant) uniform PackedMeshConstants {
+    vec4 positionOffset;
+    vec4 positionScale;
+} mesh;
+
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    vec3 position = mesh.positionOffset.xyz + mesh.positionScale.xyz * inPosition.xyz;
+    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(position, 1.0);
+    fragColor = inColor.rgb;
+    fragNormal = DecodeOctahedral(inNormal);
+    fragTexCoord = inTexCoord;
+}
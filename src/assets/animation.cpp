@@ -0,0 +1,173 @@
+#include "assets/animation.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace aero_boar {
+
+namespace {
+
+constexpr float kSnorm16Max = 32767.0f;
+constexpr float kUnorm16Max = 65535.0f;
+
+uint32_t GetTrackComponents(AnimationPath path) {
+    switch (path) {
+        case AnimationPath::Rotation: return 4;
+        case AnimationPath::Weights: return 1;
+        default: return 3;
+    }
+}
+
+uint16_t QuantizeSnorm16(float value) {
+    float clamped = std::clamp(value, -1.0f, 1.0f);
+    return static_cast<uint16_t>(static_cast<int16_t>(std::lround(clamped * kSnorm16Max)));
+}
+
+float DequantizeSnorm16(uint16_t value) {
+    return std::max(static_cast<float>(static_cast<int16_t>(value)) / kSnorm16Max, -1.0f);
+}
+
+glm::vec4 DecodeRotation(const uint16_t* sample) {
+    return glm::vec4(DequantizeSnorm16(sample[0]), DequantizeSnorm16(sample[1]), DequantizeSnorm16(sample[2]),
+                     DequantizeSnorm16(sample[3]));
+}
+
+glm::vec3 DecodeRanged(const AnimationTrack& track, const uint16_t* sample) {
+    glm::vec3 normalized(sample[0], sample[1], sample[2]);
+    return track.rangeMin + track.rangeExtent * (normalized / kUnorm16Max);
+}
+
+float DecodeWeight(const AnimationTrack& track, const uint16_t* sample) {
+    return track.rangeMin.x + track.rangeExtent.x * (static_cast<float>(sample[0]) / kUnorm16Max);
+}
+
+} // namespace
+
+void AppendAnimationTrack(AnimationClip& clip, uint32_t node, AnimationPath path,
+                          const std::vector<glm::vec4>& values, uint32_t morphWeight) {
+    if (values.empty()) {
+        return;
+    }
+
+    AnimationTrack track;
+    track.node = node;
+    track.path = path;
+    track.firstSample = static_cast<uint32_t>(clip.samples.size());
+    track.sampleCount = static_cast<uint32_t>(values.size());
+    track.morphWeight = morphWeight;
+
+    uint32_t components = GetTrackComponents(path);
+    if (path == AnimationPath::Rotation) {
+        // Neighbouring keys are kept in one hemisphere, so blending them
+        // takes the short way around
+        glm::vec4 previous(0.0f);
+        for (size_t i = 0; i < values.size(); i++) {
+            glm::vec4 rotation = values[i];
+            float length = glm::length(rotation);
+            rotation = length > 0.0f ? rotation / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            if (i > 0 && glm::dot(rotation, previous) < 0.0f) {
+                rotation = -rotation;
+            }
+            previous = rotation;
+            for (uint32_t c = 0; c < components; c++) {
+                clip.samples.push_back(QuantizeSnorm16(rotation[c]));
+            }
+        }
+    } else {
+        glm::vec3 minimum(values[0]);
+        glm::vec3 maximum(values[0]);
+        for (const auto& value : values) {
+            minimum = glm::min(minimum, glm::vec3(value));
+            maximum = glm::max(maximum, glm::vec3(value));
+        }
+        track.rangeMin = minimum;
+        track.rangeExtent = maximum - minimum;
+        for (const auto& value : values) {
+            for (uint32_t c = 0; c < components; c++) {
+                float extent = track.rangeExtent[c];
+                float normalized = extent > 0.0f ? (value[c] - minimum[c]) / extent : 0.0f;
+                clip.samples.push_back(static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) *
+                                                                         kUnorm16Max)));
+            }
+        }
+    }
+
+    // Most tracks of a DCC export never move; they keep their first sample
+    const uint16_t* first = clip.samples.data() + track.firstSample;
+    bool constant = true;
+    for (uint32_t i = 1; constant && i < track.sampleCount; i++) {
+        constant = std::equal(first, first + components, first + i * components);
+    }
+    if (constant) {
+        track.sampleCount = 1;
+        clip.samples.resize(track.firstSample + components);
+    }
+
+    clip.tracks.push_back(track);
+}
+
+void SampleAnimationClip(const AnimationClip& clip, float time, NodePose* poses, float* morphWeights) {
+    if (clip.frameCount == 0) {
+        return;
+    }
+
+    float frame = 0.0f;
+    if (clip.duration > 0.0f && clip.frameCount > 1) {
+        float looped = std::fmod(time, clip.duration);
+        if (looped < 0.0f) {
+            looped += clip.duration;
+        }
+        frame = std::min(looped * clip.sampleRate, static_cast<float>(clip.frameCount - 1));
+    }
+    uint32_t frame0 = static_cast<uint32_t>(frame);
+    uint32_t frame1 = std::min(frame0 + 1, clip.frameCount - 1);
+    float alpha = frame - static_cast<float>(frame0);
+
+    for (const auto& track : clip.tracks) {
+        uint32_t components = GetTrackComponents(track.path);
+        const uint16_t* samples = clip.samples.data() + track.firstSample;
+        const uint16_t* a = samples + (track.sampleCount > 1 ? frame0 : 0) * components;
+        const uint16_t* b = samples + (track.sampleCount > 1 ? frame1 : 0) * components;
+
+        NodePose& pose = poses[track.node];
+        switch (track.path) {
+            case AnimationPath::Weights:
+                if (morphWeights) {
+                    morphWeights[track.morphWeight] = glm::mix(DecodeWeight(track, a), DecodeWeight(track, b), alpha);
+                }
+                break;
+            case AnimationPath::Translation:
+                pose.translation = glm::mix(DecodeRanged(track, a), DecodeRanged(track, b), alpha);
+                break;
+            case AnimationPath::Scale:
+                pose.scale = glm::mix(DecodeRanged(track, a), DecodeRanged(track, b), alpha);
+                break;
+            case AnimationPath::Rotation: {
+                // Normalized lerp; at 30 Hz it is indistinguishable from slerp
+                glm::vec4 rotation = glm::mix(DecodeRotation(a), DecodeRotation(b), alpha);
+                float length = glm::length(rotation);
+                if (length > 0.0f) {
+                    rotation /= length;
+                    pose.rotation = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
+                }
+                break;
+            }
+        }
+    }
+}
+
+void ComputeNodeTransforms(const Skeleton& skeleton, const NodePose* poses, glm::mat4* transforms) {
+    for (size_t i = 0; i < skeleton.parents.size(); i++) {
+        const NodePose& pose = poses[i];
+        glm::mat3 rotation = glm::mat3_cast(pose.rotation);
+        glm::mat4 local(1.0f);
+        local[0] = glm::vec4(rotation[0] * pose.scale.x, 0.0f);
+        local[1] = glm::vec4(rotation[1] * pose.scale.y, 0.0f);
+        local[2] = glm::vec4(rotation[2] * pose.scale.z, 0.0f);
+        local[3] = glm::vec4(pose.translation, 1.0f);
+
+        int32_t parent = skeleton.parents[i];
+        transforms[i] = parent >= 0 && static_cast<size_t>(parent) < i ? transforms[parent] * local : local;
+    }
+}
+
+} // namespace aero_boar
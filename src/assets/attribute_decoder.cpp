@@ -0,0 +1,320 @@
+#include "assets/attribute_decoder.hpp"
+#include <algorithm>
+#include <cstring>
+
+// SSE2 is the x86-64 baseline and NEON the AArch64 one, so neither needs
+// extra build flags or runtime dispatch. ATTRIBUTE_DECODER_SCALAR forces the
+// portable path, which the tests compare the SIMD ones against.
+#if defined(ATTRIBUTE_DECODER_SCALAR)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ATTRIBUTE_DECODER_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ATTRIBUTE_DECODER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace aero_boar {
+
+namespace {
+
+constexpr int kByte = 5120;
+constexpr int kUnsignedByte = 5121;
+constexpr int kShort = 5122;
+constexpr int kUnsignedShort = 5123;
+constexpr int kUnsignedInt = 5125;
+constexpr int kFloat = 5126;
+
+// Every element is widened to four lanes: components past the accessor's
+// type are read and then replaced by the fill value
+#if defined(ATTRIBUTE_DECODER_SSE2)
+
+using Lanes = __m128;
+using Mask = __m128;
+
+inline Lanes Splat(float value) { return _mm_set1_ps(value); }
+inline Lanes LoadFloats(const float* values) { return _mm_loadu_ps(values); }
+inline Lanes Multiply(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+inline Lanes Maximum(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+inline Lanes Select(Mask mask, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+inline Mask FirstLanes(uint32_t count) {
+    alignas(16) static const uint32_t masks[5][4] = {
+        {0, 0, 0, 0}, {~0u, 0, 0, 0}, {~0u, ~0u, 0, 0}, {~0u, ~0u, ~0u, 0}, {~0u, ~0u, ~0u, ~0u}};
+    return _mm_load_ps(reinterpret_cast<const float*>(masks[std::min(count, 4u)]));
+}
+
+inline void StoreLanes(float* dst, Lanes value, uint32_t count) {
+    switch (count) {
+        case 1: _mm_store_ss(dst, value); break;
+        case 2: _mm_storel_pi(reinterpret_cast<__m64*>(dst), value); break;
+        case 3:
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst), value);
+            _mm_store_ss(dst + 2, _mm_movehl_ps(value, value));
+            break;
+        default: _mm_storeu_ps(dst, value); break;
+    }
+}
+
+inline Lanes WidenUnsignedBytes(uint32_t bits) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i x = _mm_cvtsi32_si128(static_cast<int>(bits));
+    x = _mm_unpacklo_epi16(_mm_unpacklo_epi8(x, zero), zero);
+    return _mm_cvtepi32_ps(x);
+}
+
+inline Lanes WidenSignedBytes(uint32_t bits) {
+    // Each byte is replicated into the top of its lane, then shifted down with sign
+    __m128i x = _mm_cvtsi32_si128(static_cast<int>(bits));
+    x = _mm_unpacklo_epi8(x, x);
+    x = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 24);
+    return _mm_cvtepi32_ps(x);
+}
+
+inline Lanes WidenUnsignedShorts(uint64_t bits) {
+    __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&bits));
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(x, _mm_setzero_si128()));
+}
+
+inline Lanes WidenSignedShorts(uint64_t bits) {
+    __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&bits));
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+}
+
+inline Lanes MakeLanes(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+
+#elif defined(ATTRIBUTE_DECODER_NEON)
+
+using Lanes = float32x4_t;
+using Mask = uint32x4_t;
+
+inline Lanes Splat(float value) { return vdupq_n_f32(value); }
+inline Lanes LoadFloats(const float* values) { return vld1q_f32(values); }
+inline Lanes Multiply(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+inline Lanes Maximum(Lanes a, Lanes b) { return vmaxq_f32(a, b); }
+inline Lanes Select(Mask mask, Lanes a, Lanes b) { return vbslq_f32(mask, a, b); }
+
+inline Mask FirstLanes(uint32_t count) {
+    static const uint32_t masks[5][4] = {
+        {0, 0, 0, 0}, {~0u, 0, 0, 0}, {~0u, ~0u, 0, 0}, {~0u, ~0u, ~0u, 0}, {~0u, ~0u, ~0u, ~0u}};
+    return vld1q_u32(masks[std::min(count, 4u)]);
+}
+
+inline void StoreLanes(float* dst, Lanes value, uint32_t count) {
+    switch (count) {
+        case 1: vst1q_lane_f32(dst, value, 0); break;
+        case 2: vst1_f32(dst, vget_low_f32(value)); break;
+        case 3:
+            vst1_f32(dst, vget_low_f32(value));
+            vst1q_lane_f32(dst + 2, value, 2);
+            break;
+        default: vst1q_f32(dst, value); break;
+    }
+}
+
+inline Lanes WidenUnsignedBytes(uint32_t bits) {
+    uint16x8_t x = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bits)));
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(x)));
+}
+
+inline Lanes WidenSignedBytes(uint32_t bits) {
+    int16x8_t x = vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(bits)));
+    return vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+}
+
+inline Lanes WidenUnsignedShorts(uint64_t bits) {
+    return vcvtq_f32_u32(vmovl_u16(vcreate_u16(bits)));
+}
+
+inline Lanes WidenSignedShorts(uint64_t bits) {
+    return vcvtq_f32_s32(vmovl_s16(vcreate_s16(bits)));
+}
+
+inline Lanes MakeLanes(float x, float y, float z, float w) {
+    const float values[4] = {x, y, z, w};
+    return vld1q_f32(values);
+}
+
+#else
+
+struct Lanes {
+    float v[4];
+};
+
+struct Mask {
+    bool v[4];
+};
+
+inline Lanes MakeLanes(float x, float y, float z, float w) { return {{x, y, z, w}}; }
+inline Lanes Splat(float value) { return MakeLanes(value, value, value, value); }
+inline Lanes LoadFloats(const float* values) { return MakeLanes(values[0], values[1], values[2], values[3]); }
+
+inline Lanes Multiply(Lanes a, Lanes b) {
+    return MakeLanes(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]);
+}
+
+inline Lanes Maximum(Lanes a, Lanes b) {
+    return MakeLanes(std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]),
+                     std::max(a.v[3], b.v[3]));
+}
+
+inline Lanes Select(Mask mask, Lanes a, Lanes b) {
+    return MakeLanes(mask.v[0] ? a.v[0] : b.v[0], mask.v[1] ? a.v[1] : b.v[1], mask.v[2] ? a.v[2] : b.v[2],
+                     mask.v[3] ? a.v[3] : b.v[3]);
+}
+
+inline Mask FirstLanes(uint32_t count) { return {{count > 0, count > 1, count > 2, count > 3}}; }
+
+inline void StoreLanes(float* dst, Lanes value, uint32_t count) {
+    std::memcpy(dst, value.v, std::min(count, 4u) * sizeof(float));
+}
+
+template<typename T>
+inline Lanes WidenLanes(uint64_t bits) {
+    T values[4];
+    std::memcpy(values, &bits, sizeof(values));
+    return MakeLanes(static_cast<float>(values[0]), static_cast<float>(values[1]), static_cast<float>(values[2]),
+                     static_cast<float>(values[3]));
+}
+
+inline Lanes WidenUnsignedBytes(uint32_t bits) { return WidenLanes<uint8_t>(bits); }
+inline Lanes WidenSignedBytes(uint32_t bits) { return WidenLanes<int8_t>(bits); }
+inline Lanes WidenUnsignedShorts(uint64_t bits) { return WidenLanes<uint16_t>(bits); }
+inline Lanes WidenSignedShorts(uint64_t bits) { return WidenLanes<int16_t>(bits); }
+
+#endif
+
+template<int ComponentType>
+struct ComponentTraits;
+
+template<> struct ComponentTraits<kByte> { using Type = int8_t; static constexpr float kScale = 1.0f / 127.0f; };
+template<> struct ComponentTraits<kUnsignedByte> { using Type = uint8_t; static constexpr float kScale = 1.0f / 255.0f; };
+template<> struct ComponentTraits<kShort> { using Type = int16_t; static constexpr float kScale = 1.0f / 32767.0f; };
+template<> struct ComponentTraits<kUnsignedShort> { using Type = uint16_t; static constexpr float kScale = 1.0f / 65535.0f; };
+template<> struct ComponentTraits<kUnsignedInt> { using Type = uint32_t; static constexpr float kScale = 1.0f / 4294967295.0f; };
+template<> struct ComponentTraits<kFloat> { using Type = float; static constexpr float kScale = 1.0f; };
+
+// Reads four components' worth of bytes at src and widens them to floats
+template<int ComponentType>
+inline Lanes LoadElement(const unsigned char* src) {
+    if constexpr (ComponentType == kFloat) {
+        float values[4];
+        std::memcpy(values, src, sizeof(values));
+        return LoadFloats(values);
+    } else if constexpr (ComponentType == kUnsignedInt) {
+        // Rare for attributes; converted lane by lane to keep the full unsigned range
+        uint32_t values[4];
+        std::memcpy(values, src, sizeof(values));
+        return MakeLanes(static_cast<float>(values[0]), static_cast<float>(values[1]),
+                         static_cast<float>(values[2]), static_cast<float>(values[3]));
+    } else if constexpr (sizeof(typename ComponentTraits<ComponentType>::Type) == 1) {
+        uint32_t bits;
+        std::memcpy(&bits, src, sizeof(bits));
+        return ComponentType == kByte ? WidenSignedBytes(bits) : WidenUnsignedBytes(bits);
+    } else {
+        uint64_t bits;
+        std::memcpy(&bits, src, sizeof(bits));
+        return ComponentType == kShort ? WidenSignedShorts(bits) : WidenUnsignedShorts(bits);
+    }
+}
+
+template<int ComponentType>
+void DecodeElements(const AttributeStream& source, unsigned char* dst, size_t dstStride, uint32_t dstComponents,
+                    const float fill[4]) {
+    constexpr size_t kLoadSize = 4 * sizeof(typename ComponentTraits<ComponentType>::Type);
+    constexpr bool kSigned = ComponentType == kByte || ComponentType == kShort;
+
+    // Normalized signed values clamp at -1 (the most negative integer maps below it)
+    const Lanes scale = Splat(source.normalized ? ComponentTraits<ComponentType>::kScale : 1.0f);
+    const Lanes lowest = Splat(source.normalized && kSigned ? -1.0f : -3.402823466e+38f);
+    const Lanes fillLanes = LoadFloats(fill);
+    const Mask sourceLanes = FirstLanes(source.components);
+
+    // Elements whose full four-component load stays inside the buffer take
+    // the fast path; the last few are copied out first
+    size_t fastCount = 0;
+    if (source.available >= kLoadSize) {
+        fastCount = std::min(source.count, (source.available - kLoadSize) / source.stride + 1);
+    }
+
+    const unsigned char* src = source.data;
+    for (size_t i = 0; i < fastCount; i++) {
+        Lanes value = Maximum(Multiply(LoadElement<ComponentType>(src), scale), lowest);
+        StoreLanes(reinterpret_cast<float*>(dst), Select(sourceLanes, value, fillLanes), dstComponents);
+        src += source.stride;
+        dst += dstStride;
+    }
+
+    for (size_t i = fastCount; i < source.count; i++) {
+        unsigned char padded[kLoadSize] = {};
+        std::memcpy(padded, src, std::min(kLoadSize, source.available - i * source.stride));
+        Lanes value = Maximum(Multiply(LoadElement<ComponentType>(padded), scale), lowest);
+        StoreLanes(reinterpret_cast<float*>(dst), Select(sourceLanes, value, fillLanes), dstComponents);
+        src += source.stride;
+        dst += dstStride;
+    }
+}
+
+using DecodeFunction = void (*)(const AttributeStream&, unsigned char*, size_t, uint32_t, const float[4]);
+
+struct ComponentFormat {
+    int componentType;
+    size_t size;
+    DecodeFunction decode;
+};
+
+const ComponentFormat kComponentFormats[] = {
+    {kByte, 1, &DecodeElements<kByte>},
+    {kUnsignedByte, 1, &DecodeElements<kUnsignedByte>},
+    {kShort, 2, &DecodeElements<kShort>},
+    {kUnsignedShort, 2, &DecodeElements<kUnsignedShort>},
+    {kUnsignedInt, 4, &DecodeElements<kUnsignedInt>},
+    {kFloat, 4, &DecodeElements<kFloat>},
+};
+
+const ComponentFormat* FindComponentFormat(int componentType) {
+    for (const auto& format : kComponentFormats) {
+        if (format.componentType == componentType) {
+            return &format;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+size_t GetComponentSize(int componentType) {
+    const ComponentFormat* format = FindComponentFormat(componentType);
+    return format ? format->size : 0;
+}
+
+bool DecodeAttribute(const AttributeStream& source, float* dst, size_t dstStride, uint32_t dstComponents,
+                     const float fill[4]) {
+    const ComponentFormat* format = FindComponentFormat(source.componentType);
+    if (!format || !source.data || source.components == 0 || source.components > 4 || source.stride == 0) {
+        return false;
+    }
+    if (source.count == 0) {
+        return true;
+    }
+
+    // The last element must end inside the buffer
+    size_t elementSize = format->size * source.components;
+    if (source.available < elementSize || (source.count - 1) > (source.available - elementSize) / source.stride) {
+        return false;
+    }
+
+    format->decode(source, reinterpret_cast<unsigned char*>(dst), dstStride, dstComponents, fill);
+    return true;
+}
+
+void FillAttribute(float* dst, size_t dstStride, size_t count, uint32_t dstComponents, const float value[4]) {
+    const Lanes lanes = LoadFloats(value);
+    unsigned char* out = reinterpret_cast<unsigned char*>(dst);
+    for (size_t i = 0; i < count; i++) {
+        StoreLanes(reinterpret_cast<float*>(out), lanes, dstComponents);
+        out += dstStride;
+    }
+}
+
+} // namespace aero_boar
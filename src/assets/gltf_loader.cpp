@@ -1,14 +1,424 @@
 #include "assets/gltf_loader.hpp"
+#include "assets/attribute_decoder.hpp"
+#include "assets/ktx2.hpp"
+#include "assets/meshopt_decoder.hpp"
+#include "assets/mesh_optimizer.hpp"
+#include "assets/mesh_cache.hpp"
+#include "assets/vertex_packing.hpp"
 #include "core/transfer_manager.hpp"
+#include <stb_image.h>
+#include <json.hpp>
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstring>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace aero_boar {
 
+namespace {
+
+VkSamplerAddressMode GetVkAddressMode(int wrap) {
+    switch (wrap) {
+        case TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE: return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        case TINYGLTF_TEXTURE_WRAP_MIRRORED_REPEAT: return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+        default: return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    }
+}
+
+VkFilter GetVkFilter(int filter) {
+    switch (filter) {
+        case TINYGLTF_TEXTURE_FILTER_NEAREST:
+        case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST:
+        case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR:
+            return VK_FILTER_NEAREST;
+        default:
+            return VK_FILTER_LINEAR;
+    }
+}
+
+// Locates an accessor's data in its buffer view. Accepts every layout glTF
+// allows, including interleaved views and KHR_mesh_quantization types; sparse
+// accessors are not supported.
+bool GetAccessorStream(const tinygltf::Model& gltfModel, const std::vector<BufferSpan>& buffers, int accessorIndex,
+                       AttributeStream& stream) {
+    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(gltfModel.accessors.size())) {
+        return false;
+    }
+
+    const auto& accessor = gltfModel.accessors[accessorIndex];
+    if (accessor.sparse.isSparse || accessor.bufferView < 0 ||
+        accessor.bufferView >= static_cast<int>(gltfModel.bufferViews.size())) {
+        return false;
+    }
+
+    const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
+    if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(buffers.size())) {
+        return false;
+    }
+
+    const BufferSpan& buffer = buffers[bufferView.buffer];
+    size_t viewEnd = std::min(buffer.size, bufferView.byteOffset + bufferView.byteLength);
+    size_t offset = bufferView.byteOffset + accessor.byteOffset;
+    int stride = accessor.ByteStride(bufferView);
+    if (stride <= 0 || offset > viewEnd) {
+        return false;
+    }
+
+    stream.data = buffer.data + offset;
+    stream.available = viewEnd - offset;
+    stream.count = accessor.count;
+    stream.stride = static_cast<size_t>(stride);
+    stream.componentType = accessor.componentType;
+    stream.components = static_cast<uint32_t>(std::max(tinygltf::GetNumComponentsInType(accessor.type), 0));
+    stream.normalized = accessor.normalized;
+    return true;
+}
+
+bool GetAttributeStream(const tinygltf::Model& gltfModel, const std::vector<BufferSpan>& buffers,
+                        const tinygltf::Primitive& primitive, const char* name, AttributeStream& stream) {
+    auto attribute = primitive.attributes.find(name);
+    return attribute != primitive.attributes.end() &&
+           GetAccessorStream(gltfModel, buffers, attribute->second, stream);
+}
+
+// Decodes a whole accessor of up to four components per element
+bool ReadAccessor(const tinygltf::Model& gltfModel, const std::vector<BufferSpan>& buffers, int accessorIndex,
+                  std::vector<glm::vec4>& values) {
+    static const float kFill[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    AttributeStream stream;
+    if (!GetAccessorStream(gltfModel, buffers, accessorIndex, stream)) {
+        return false;
+    }
+    values.resize(stream.count);
+    return stream.count == 0 || DecodeAttribute(stream, &values[0].x, sizeof(glm::vec4), 4, kFill);
+}
+
+// Decodes a MAT4 float accessor one column at a time
+bool ReadMatrices(const tinygltf::Model& gltfModel, const std::vector<BufferSpan>& buffers, int accessorIndex,
+                  std::vector<glm::mat4>& matrices) {
+    static const float kFill[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    AttributeStream stream;
+    if (!GetAccessorStream(gltfModel, buffers, accessorIndex, stream) || stream.components != 16 ||
+        stream.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
+        return false;
+    }
+    matrices.resize(stream.count);
+    for (uint32_t column = 0; column < 4 && stream.count > 0; column++) {
+        size_t offset = column * sizeof(glm::vec4);
+        if (stream.available < offset) {
+            return false;
+        }
+        AttributeStream columnStream = stream;
+        columnStream.data += offset;
+        columnStream.available -= offset;
+        columnStream.components = 4;
+        if (!DecodeAttribute(columnStream, &matrices[0][column].x, sizeof(glm::mat4), 4, kFill)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// glTF requires every primitive of a mesh to have the same targets; the
+// largest count covers files that do not
+uint32_t GetMorphTargetCount(const tinygltf::Mesh& mesh) {
+    size_t count = 0;
+    for (const auto& primitive : mesh.primitives) {
+        count = std::max(count, primitive.targets.size());
+    }
+    return static_cast<uint32_t>(count);
+}
+
+// Rest pose of a node. Matrix nodes are decomposed; glTF forbids animating
+// them, so the pose only has to reproduce the matrix.
+NodePose GetNodePose(const tinygltf::Node& node) {
+    NodePose pose;
+    if (node.matrix.size() == 16) {
+        glm::mat4 matrix;
+        for (int i = 0; i < 16; i++) {
+            matrix[i / 4][i % 4] = static_cast<float>(node.matrix[i]);
+        }
+        glm::mat3 basis(matrix);
+        pose.translation = glm::vec3(matrix[3]);
+        pose.scale = glm::vec3(glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]));
+        if (glm::determinant(basis) < 0.0f) {
+            pose.scale.x = -pose.scale.x;
+        }
+        for (int i = 0; i < 3; i++) {
+            basis[i] = pose.scale[i] != 0.0f ? basis[i] / pose.scale[i] : basis[i];
+        }
+        pose.rotation = glm::normalize(glm::quat_cast(basis));
+        return pose;
+    }
+    if (node.translation.size() == 3) {
+        pose.translation = glm::vec3(node.translation[0], node.translation[1], node.translation[2]);
+    }
+    if (node.rotation.size() == 4) {
+        pose.rotation = glm::normalize(glm::quat(static_cast<float>(node.rotation[3]),
+                                                 static_cast<float>(node.rotation[0]),
+                                                 static_cast<float>(node.rotation[1]),
+                                                 static_cast<float>(node.rotation[2])));
+    }
+    if (node.scale.size() == 3) {
+        pose.scale = glm::vec3(node.scale[0], node.scale[1], node.scale[2]);
+    }
+    return pose;
+}
+
+// Value of a glTF animation sampler at time, with its own interpolation.
+// Cubic spline outputs hold an in-tangent, value and out-tangent per key.
+glm::vec4 EvaluateSampler(const std::vector<float>& times, const std::vector<glm::vec4>& values,
+                          const std::string& interpolation, bool rotation, float time) {
+    bool cubic = interpolation == "CUBICSPLINE";
+    size_t stride = cubic ? 3 : 1;
+    size_t keys = std::min(times.size(), values.size() / stride);
+    if (keys == 0) {
+        return glm::vec4(0.0f);
+    }
+    auto value = [&](size_t key) { return values[key * stride + (cubic ? 1 : 0)]; };
+    if (time <= times[0] || keys == 1) {
+        return value(0);
+    }
+    if (time >= times[keys - 1]) {
+        return value(keys - 1);
+    }
+
+    size_t next = static_cast<size_t>(std::upper_bound(times.begin(), times.begin() + keys, time) - times.begin());
+    size_t key = next - 1;
+    float span = times[next] - times[key];
+    float t = span > 0.0f ? (time - times[key]) / span : 0.0f;
+
+    if (interpolation == "STEP") {
+        return value(key);
+    }
+    if (cubic) {
+        float t2 = t * t;
+        float t3 = t2 * t;
+        glm::vec4 outTangent = values[key * 3 + 2] * span;
+        glm::vec4 inTangent = values[next * 3] * span;
+        return (2.0f * t3 - 3.0f * t2 + 1.0f) * value(key) + (t3 - 2.0f * t2 + t) * outTangent +
+               (-2.0f * t3 + 3.0f * t2) * value(next) + (t3 - t2) * inTangent;
+    }
+    if (rotation) {
+        glm::vec4 a = value(key);
+        glm::vec4 b = value(next);
+        glm::quat slerped = glm::slerp(glm::quat(a.w, a.x, a.y, a.z), glm::quat(b.w, b.x, b.y, b.z), t);
+        return glm::vec4(slerped.x, slerped.y, slerped.z, slerped.w);
+    }
+    return glm::mix(value(key), value(next), t);
+}
+
+constexpr const char* kMeshoptExtension = "EXT_meshopt_compression";
+constexpr const char* kDracoExtension = "KHR_draco_mesh_compression";
+constexpr const char* kStubDataUri = "data:application/octet-stream;base64,AA==";
+constexpr uint32_t kGlbMagic = 0x46546C67;
+constexpr uint32_t kGlbHeaderSize = 12;
+constexpr uint32_t kGlbChunkHeaderSize = 8;
+constexpr uint32_t kGlbJsonChunk = 0x4E4F534A;
+constexpr uint32_t kGlbBinChunk = 0x004E4942;
+// Longer clips are almost certainly bad key times; resampling them would not fit in memory
+constexpr float kMaxAnimationDuration = 3600.0f;
+
+// EXT_meshopt_compression fallback buffers hold nothing the decoder needs,
+// and tinygltf either rejects them or reads them from disk. Each becomes a
+// one-byte data URI instead. Returns false if none changed.
+bool StubMeshoptFallbackBuffers(nlohmann::json& json) {
+    auto used = json.find("extensionsUsed");
+    auto buffers = json.find("buffers");
+    if (used == json.end() || buffers == json.end() ||
+        std::none_of(used->begin(), used->end(), [](const nlohmann::json& name) {
+            return name.is_string() && name.get<std::string>() == kMeshoptExtension;
+        })) {
+        return false;
+    }
+
+    bool stubbed = false;
+    for (auto& buffer : *buffers) {
+        auto extensions = buffer.find("extensions");
+        if (extensions == buffer.end() || !extensions->contains(kMeshoptExtension) ||
+            !(*extensions)[kMeshoptExtension].value("fallback", false)) {
+            continue;
+        }
+        buffer["uri"] = kStubDataUri;
+        buffer["byteLength"] = 1;
+        stubbed = true;
+    }
+    return stubbed;
+}
+
+// What tinygltf is given to parse. A GLB's BIN chunk is left out, since
+// tinygltf would copy it whole: its buffer and the images stored in it are
+// stubbed in the JSON and read from the mapped file afterwards.
+struct PreparedGltf {
+    std::string patchedJson;
+    std::string_view json;
+    BufferSpan bin;
+    int binBuffer = -1;
+    std::vector<std::pair<int, int>> binImages; // Image and its buffer view
+};
+
+// Stubs buffer 0, which a GLB stores in its BIN chunk, and the images in it
+bool StubGlbBinBuffer(nlohmann::json& json, BufferSpan binChunk, PreparedGltf& prepared, std::string& error) {
+    auto buffers = json.find("buffers");
+    if (buffers == json.end() || !buffers->is_array() || buffers->empty() || (*buffers)[0].contains("uri")) {
+        return false;
+    }
+
+    auto& buffer = (*buffers)[0];
+    size_t byteLength = buffer.value("byteLength", size_t(0));
+    if (byteLength > binChunk.size) {
+        error = "GLB buffer 0 is larger than its BIN chunk";
+        return false;
+    }
+    prepared.bin = BufferSpan{ binChunk.data, byteLength };
+    prepared.binBuffer = 0;
+    buffer["uri"] = kStubDataUri;
+    buffer["byteLength"] = 1;
+
+    // tinygltf would read these images out of the stub
+    auto images = json.find("images");
+    auto bufferViews = json.find("bufferViews");
+    if (images == json.end() || bufferViews == json.end()) {
+        return true;
+    }
+    for (size_t i = 0; i < images->size(); i++) {
+        auto& image = (*images)[i];
+        int view = image.value("bufferView", -1);
+        if (view < 0 || view >= static_cast<int>(bufferViews->size()) ||
+            (*bufferViews)[static_cast<size_t>(view)].value("buffer", -1) != 0) {
+            continue;
+        }
+        prepared.binImages.emplace_back(static_cast<int>(i), view);
+        image.erase("bufferView");
+        image["uri"] = kStubDataUri;
+    }
+    return true;
+}
+
+bool PrepareGltf(const unsigned char* data, size_t size, bool binary, PreparedGltf& prepared, std::string& error) {
+    prepared.json = std::string_view(reinterpret_cast<const char*>(data), size);
+    BufferSpan binChunk;
+    if (binary) {
+        uint32_t magic = 0;
+        uint32_t chunkLength = 0;
+        uint32_t chunkType = 0;
+        if (size >= kGlbHeaderSize + kGlbChunkHeaderSize) {
+            std::memcpy(&magic, data, sizeof(magic));
+            std::memcpy(&chunkLength, data + kGlbHeaderSize, sizeof(chunkLength));
+            std::memcpy(&chunkType, data + kGlbHeaderSize + 4, sizeof(chunkType));
+        }
+        size_t jsonOffset = kGlbHeaderSize + kGlbChunkHeaderSize;
+        if (magic != kGlbMagic || chunkType != kGlbJsonChunk || chunkLength > size - jsonOffset) {
+            error = "Invalid GLB header";
+            return false;
+        }
+        prepared.json = std::string_view(reinterpret_cast<const char*>(data) + jsonOffset, chunkLength);
+
+        // The BIN chunk is optional
+        size_t binOffset = jsonOffset + chunkLength;
+        if (size - binOffset >= kGlbChunkHeaderSize) {
+            std::memcpy(&chunkLength, data + binOffset, sizeof(chunkLength));
+            std::memcpy(&chunkType, data + binOffset + 4, sizeof(chunkType));
+            if (chunkType == kGlbBinChunk && chunkLength <= size - binOffset - kGlbChunkHeaderSize) {
+                binChunk = BufferSpan{ data + binOffset + kGlbChunkHeaderSize, chunkLength };
+            }
+        }
+    }
+
+    // Other files are only scanned, not parsed, before tinygltf
+    bool usesMeshopt = prepared.json.find(kMeshoptExtension) != std::string_view::npos;
+    if (!usesMeshopt && !binChunk.data) {
+        return true;
+    }
+
+    nlohmann::json json = nlohmann::json::parse(prepared.json);
+    bool patched = usesMeshopt && StubMeshoptFallbackBuffers(json);
+    if (binChunk.data) {
+        patched = StubGlbBinBuffer(json, binChunk, prepared, error) || patched;
+        if (!error.empty()) {
+            return false;
+        }
+    }
+    if (patched) {
+        prepared.patchedJson = json.dump();
+        prepared.json = prepared.patchedJson;
+    }
+    return true;
+}
+
+void LogVertexCacheStats(const CookedModel& cooked) {
+    VertexCacheStats sourceStats;
+    VertexCacheStats optimizedStats;
+    for (const auto& mesh : cooked.meshes) {
+        sourceStats.Add(mesh.sourceCacheStats);
+        optimizedStats.Add(mesh.cacheStats);
+    }
+    if (optimizedStats.triangleCount > 0) {
+        std::cout << "Vertex cache: ACMR " << sourceStats.GetAcmr() << " -> " << optimizedStats.GetAcmr()
+                  << ", ATVR " << sourceStats.GetAtvr() << " -> " << optimizedStats.GetAtvr() << std::endl;
+    }
+}
+
+// Applies a fetch order from OptimizeVertexFetch on vertex ids: new vertex v
+// is old vertex order[v]. Morph deltas are kept grouped per vertex, with
+// offsets holding one start per vertex plus the end.
+void ReorderSkinnedVertices(const std::vector<uint32_t>& order, std::vector<SkinnedVertex>& vertices,
+                            std::vector<MorphDelta>& morphDeltas, std::vector<uint32_t>& morphOffsets) {
+    std::vector<SkinnedVertex> reorderedVertices(order.size());
+    std::vector<MorphDelta> reorderedDeltas;
+    std::vector<uint32_t> reorderedOffsets(order.size() + 1, 0);
+    reorderedDeltas.reserve(morphDeltas.size());
+    for (size_t v = 0; v < order.size(); v++) {
+        uint32_t source = order[v];
+        reorderedVertices[v] = vertices[source];
+        reorderedOffsets[v] = static_cast<uint32_t>(reorderedDeltas.size());
+        reorderedDeltas.insert(reorderedDeltas.end(), morphDeltas.begin() + morphOffsets[source],
+                               morphDeltas.begin() + morphOffsets[source + 1]);
+    }
+    reorderedOffsets[order.size()] = static_cast<uint32_t>(reorderedDeltas.size());
+    vertices.swap(reorderedVertices);
+    morphDeltas.swap(reorderedDeltas);
+    morphOffsets.swap(reorderedOffsets);
+}
+
+} // namespace
+
+AssetConfig AssetConfig::LoadFromFile(const std::string& filepath) {
+    AssetConfig config;
+
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cout << "Asset config not found at " << filepath << ", using defaults" << std::endl;
+        return config;
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        if (json.contains("meshCacheDirectory")) {
+            config.meshCacheDirectory = json["meshCacheDirectory"].get<std::string>();
+        }
+        if (json.contains("packVertices")) {
+            config.packVertices = json["packVertices"].get<bool>();
+        }
+        if (json.contains("packedPositionTolerance")) {
+            config.packedPositionTolerance = json["packedPositionTolerance"].get<float>();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to parse asset config " << filepath << ": " << e.what() << std::endl;
+    }
+
+    return config;
+}
+
 // AssetThreadPool implementation
 AssetThreadPool::AssetThreadPool(size_t numThreads) : stop(false) {
     for (size_t i = 0; i < numThreads; ++i) {
@@ -68,9 +478,97 @@ void AssetThreadPool::Shutdown() {
     }
 }
 
+// AssetTaskGroup implementation
+AssetTaskGroup::AssetTaskGroup(AssetThreadPool* pool) : m_pool(pool), m_state(std::make_shared<State>()) {}
+
+AssetTaskGroup::~AssetTaskGroup() {
+    WaitAll();
+}
+
+void AssetTaskGroup::Run(std::function<void()> task) {
+    if (!m_pool) {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->queued.push(std::move(task));
+        m_state->pending++;
+    }
+    m_state->changed.notify_all();
+
+    // One worker entry per task; it finds the queue empty when the waiter
+    // got there first. A stopping pool leaves the task to the waiter.
+    try {
+        m_pool->Enqueue([state = m_state]() { RunQueuedTask(*state); });
+    } catch (const std::runtime_error&) {
+    }
+}
+
+bool AssetTaskGroup::RunQueuedTask(State& state) {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.queued.empty()) {
+            return false;
+        }
+        task = std::move(state.queued.front());
+        state.queued.pop();
+    }
+
+    std::exception_ptr error;
+    try {
+        task();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (error && !state.error) {
+        state.error = error;
+    }
+    if (--state.pending == 0) {
+        state.changed.notify_all();
+    }
+    return true;
+}
+
+void AssetTaskGroup::Wait() {
+    WaitAll();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        error = m_state->error;
+        m_state->error = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void AssetTaskGroup::WaitAll() {
+    // Sleeps only while every unfinished task has started on a worker; tasks
+    // may add more to the group, which wakes the waiter to help again
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    while (m_state->pending > 0) {
+        if (!m_state->queued.empty()) {
+            lock.unlock();
+            RunQueuedTask(*m_state);
+            lock.lock();
+            continue;
+        }
+        m_state->changed.wait(lock, [this] { return m_state->pending == 0 || !m_state->queued.empty(); });
+    }
+}
+
 // GltfLoader implementation
-GltfLoader::GltfLoader(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator)
-    : m_device(device), m_physicalDevice(physicalDevice), m_allocator(allocator) {
+GltfLoader::GltfLoader(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator,
+                       const TransferQueueInfo& transferQueue, uint32_t framesInFlight,
+                       const TransferConfig& transferConfig, const AssetConfig& assetConfig)
+    : m_device(device), m_physicalDevice(physicalDevice), m_allocator(allocator),
+      m_transferQueue(transferQueue), m_transferConfig(transferConfig), m_assetConfig(assetConfig),
+      m_framesInFlight(framesInFlight) {
 }
 
 GltfLoader::~GltfLoader() {
@@ -83,12 +581,67 @@ bool GltfLoader::Initialize() {
         m_threadPool = std::make_unique<AssetThreadPool>();
         
         // Create transfer manager
-        m_transferManager = std::make_unique<TransferManager>(m_device, m_physicalDevice, m_allocator);
+        m_transferManager = std::make_unique<TransferManager>(m_device, m_physicalDevice, m_allocator,
+                                                              m_transferQueue, m_transferConfig);
         if (!m_transferManager->Initialize()) {
             std::cerr << "Failed to initialize transfer manager" << std::endl;
             return false;
         }
 
+        // Static mesh data of every model shares one vertex and one index buffer
+        m_geometryArena = std::make_unique<GeometryArena>(m_device, m_allocator, *m_transferManager,
+                                                          sizeof(Vertex), m_framesInFlight);
+        if (!m_geometryArena->Initialize()) {
+            std::cerr << "Failed to initialize geometry arena" << std::endl;
+            return false;
+        }
+
+        // Packed meshes draw with their own vertex layout, so they need their own buffers
+        if (m_assetConfig.packVertices) {
+            m_packedGeometryArena = std::make_unique<GeometryArena>(m_device, m_allocator, *m_transferManager,
+                                                                    sizeof(PackedVertex), m_framesInFlight);
+            if (!m_packedGeometryArena->Initialize()) {
+                std::cerr << "Failed to initialize packed geometry arena" << std::endl;
+                return false;
+            }
+        }
+
+        // Skinned meshes are only read by the skinning pass, as a storage buffer
+        GeometryArenaConfig skinnedConfig;
+        skinnedConfig.vertexCapacity = 32ull * 1024 * 1024;
+        skinnedConfig.indexCapacity = 16ull * 1024 * 1024;
+        skinnedConfig.vertexUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        m_skinnedGeometryArena = std::make_unique<GeometryArena>(m_device, m_allocator, *m_transferManager,
+                                                                 sizeof(SkinnedVertex), m_framesInFlight,
+                                                                 skinnedConfig);
+        if (!m_skinnedGeometryArena->Initialize()) {
+            std::cerr << "Failed to initialize skinned geometry arena" << std::endl;
+            return false;
+        }
+
+        // Morph deltas are also only read by the skinning pass, and reuse the
+        // arena's allocation, compaction and deferred frees
+        GeometryArenaConfig morphConfig;
+        morphConfig.vertexCapacity = 16ull * 1024 * 1024;
+        morphConfig.indexCapacity = 8ull * 1024 * 1024;
+        morphConfig.vertexUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        morphConfig.indexUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        m_morphArena = std::make_unique<GeometryArena>(m_device, m_allocator, *m_transferManager,
+                                                       sizeof(MorphDelta), m_framesInFlight, morphConfig);
+        if (!m_morphArena->Initialize()) {
+            std::cerr << "Failed to initialize morph arena" << std::endl;
+            return false;
+        }
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+        m_maxSamplerAnisotropy = properties.limits.maxSamplerAnisotropy;
+
+        // Cooked models let later loads of unchanged files skip glTF parsing
+        if (!m_assetConfig.meshCacheDirectory.empty()) {
+            m_meshCache = std::make_unique<MeshCache>(m_assetConfig.meshCacheDirectory);
+        }
+
         std::cout << "GltfLoader initialized successfully" << std::endl;
         return true;
     } catch (const std::exception& e) {
@@ -116,50 +669,50 @@ void GltfLoader::Shutdown() {
         // Cleanup all loaded models BEFORE shutting down transfer manager
         {
             std::cout << "Cleaning up loaded models..." << std::endl;
+            std::vector<ModelLoadCompletion> undrained;
+            DrainCompletedLoads(undrained);
             std::lock_guard<std::mutex> lock(m_modelsMutex);
-            for (auto& [name, model] : m_loadedModels) {
-                if (model) {
-                    // Cleanup model resources
-                    for (auto& mesh : model->meshes) {
-                        if (mesh.vertexBuffer != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
-                            vkDestroyBuffer(m_device, mesh.vertexBuffer, nullptr);
-                            mesh.vertexBuffer = VK_NULL_HANDLE;
-                        }
-                        if (mesh.indexBuffer != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
-                            vkDestroyBuffer(m_device, mesh.indexBuffer, nullptr);
-                            mesh.indexBuffer = VK_NULL_HANDLE;
-                        }
-                        if (mesh.vertexBufferAllocation != VK_NULL_HANDLE && m_allocator != VK_NULL_HANDLE) {
-                            vmaFreeMemory(m_allocator, mesh.vertexBufferAllocation);
-                            mesh.vertexBufferAllocation = VK_NULL_HANDLE;
-                        }
-                        if (mesh.indexBufferAllocation != VK_NULL_HANDLE && m_allocator != VK_NULL_HANDLE) {
-                            vmaFreeMemory(m_allocator, mesh.indexBufferAllocation);
-                            mesh.indexBufferAllocation = VK_NULL_HANDLE;
-                        }
-                    }
-                    
-                    for (auto& material : model->materials) {
-                        if (material.baseColorTexture != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
-                            vkDestroyImage(m_device, material.baseColorTexture, nullptr);
-                            material.baseColorTexture = VK_NULL_HANDLE;
-                        }
-                        if (material.baseColorTextureView != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
-                            vkDestroyImageView(m_device, material.baseColorTextureView, nullptr);
-                            material.baseColorTextureView = VK_NULL_HANDLE;
-                        }
-                        if (material.baseColorSampler != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
-                            vkDestroySampler(m_device, material.baseColorSampler, nullptr);
-                            material.baseColorSampler = VK_NULL_HANDLE;
-                        }
-                        if (material.baseColorTextureAllocation != VK_NULL_HANDLE && m_allocator != VK_NULL_HANDLE) {
-                            vmaFreeMemory(m_allocator, material.baseColorTextureAllocation);
-                            material.baseColorTextureAllocation = VK_NULL_HANDLE;
-                        }
-                    }
+            for (auto& [name, entry] : m_loadedModels) {
+                if (entry.model) {
+                    DestroyModelResources(*entry.model);
                 }
             }
             m_loadedModels.clear();
+            m_inFlightLoads.clear();
+            m_loadRequests.clear();
+            m_pendingModels.clear();
+            for (auto& reloaded : m_reloadedModels) {
+                DestroyModelResources(*reloaded.model);
+            }
+            m_reloadedModels.clear();
+            m_residentBytes = 0;
+        }
+
+        // The device is idle by now, so nothing samples retired textures
+        {
+            std::lock_guard<std::mutex> lock(m_retiredTexturesMutex);
+            for (auto& retired : m_retiredTextures) {
+                DestroyTexture(retired.texture);
+            }
+            m_retiredTextures.clear();
+            m_retiredTextureBytes = 0;
+        }
+
+        if (m_geometryArena) {
+            m_geometryArena->Shutdown();
+            m_geometryArena.reset();
+        }
+        if (m_packedGeometryArena) {
+            m_packedGeometryArena->Shutdown();
+            m_packedGeometryArena.reset();
+        }
+        if (m_skinnedGeometryArena) {
+            m_skinnedGeometryArena->Shutdown();
+            m_skinnedGeometryArena.reset();
+        }
+        if (m_morphArena) {
+            m_morphArena->Shutdown();
+            m_morphArena.reset();
         }
 
         // Shutdown transfer manager after cleaning up resources
@@ -175,50 +728,195 @@ void GltfLoader::Shutdown() {
     std::cout << "GltfLoader::Shutdown() completed" << std::endl;
 }
 
-std::future<AssetLoadResult> GltfLoader::LoadModelAsync(const std::string& filepath) {
-    return m_threadPool->Enqueue([this, filepath]() -> AssetLoadResult {
-        return LoadModel(filepath);
-    });
+std::shared_future<AssetLoadResult> GltfLoader::LoadModelAsync(const std::string& filepath) {
+    std::shared_ptr<std::promise<AssetLoadResult>> promise;
+    std::shared_future<AssetLoadResult> future = FindOrStartLoad(filepath, promise);
+    if (promise) {
+        StartLoad(filepath, promise);
+    }
+    return future;
+}
+
+ModelRequestId GltfLoader::RequestModel(const std::string& filepath) {
+    ModelRequestId request = m_nextRequestId.fetch_add(1);
+    std::shared_ptr<std::promise<AssetLoadResult>> promise;
+    FindOrStartLoad(filepath, promise, request);
+    if (promise) {
+        StartLoad(filepath, promise);
+    }
+    return request;
+}
+
+void GltfLoader::DrainCompletedLoads(std::vector<ModelLoadCompletion>& completions) {
+    CompletedLoad* head = m_completedHead.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack holds the newest first
+    CompletedLoad* oldest = nullptr;
+    while (head) {
+        CompletedLoad* next = head->next;
+        head->next = oldest;
+        oldest = head;
+        head = next;
+    }
+    while (oldest) {
+        CompletedLoad* next = oldest->next;
+        completions.push_back(std::move(oldest->completion));
+        delete oldest;
+        oldest = next;
+    }
+}
+
+void GltfLoader::CompleteRequests(const std::string& filepath, const std::vector<ModelRequestId>& requests,
+                                  const AssetLoadResult& result) {
+    for (ModelRequestId request : requests) {
+        auto* completed = new CompletedLoad();
+        completed->completion.request = request;
+        completed->completion.filepath = filepath;
+        completed->completion.result = result;
+
+        // Lock-free push; the render thread is the single consumer
+        completed->next = m_completedHead.load(std::memory_order_relaxed);
+        while (!m_completedHead.compare_exchange_weak(completed->next, completed,
+                                                      std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
 }
 
 AssetLoadResult GltfLoader::LoadModel(const std::string& filepath) {
-    AssetLoadResult result;
-    
+    std::shared_ptr<std::promise<AssetLoadResult>> promise;
+    std::shared_future<AssetLoadResult> future = FindOrStartLoad(filepath, promise);
+    if (promise) {
+        AssetLoadResult result = RunLoad(filepath);
+        promise->set_value(result);
+        return result;
+    }
+
+    // Another thread is loading it. Its subtasks are run by their own group's
+    // waiter, so blocking here cannot stall that load.
+    return future.get();
+}
+
+std::shared_future<AssetLoadResult> GltfLoader::FindOrStartLoad(const std::string& filepath,
+                                                                std::shared_ptr<std::promise<AssetLoadResult>>& promise,
+                                                                ModelRequestId request) {
+    std::lock_guard<std::mutex> lock(m_modelsMutex);
+
+    auto loaded = m_loadedModels.find(filepath);
+    if (loaded != m_loadedModels.end()) {
+        AssetLoadResult result;
+        result.model = loaded->second.model;
+        result.success = true;
+        if (request != 0) {
+            CompleteRequests(filepath, { request }, result);
+        }
+        std::promise<AssetLoadResult> ready;
+        ready.set_value(result);
+        return ready.get_future().share();
+    }
+
+    // Registered under the same lock RunLoad completes under, so no request is missed
+    if (request != 0) {
+        m_loadRequests[filepath].push_back(request);
+    }
+
+    auto inFlight = m_inFlightLoads.find(filepath);
+    if (inFlight != m_inFlightLoads.end()) {
+        return inFlight->second;
+    }
+
+    promise = std::make_shared<std::promise<AssetLoadResult>>();
+    std::shared_future<AssetLoadResult> future = promise->get_future().share();
+    m_inFlightLoads.emplace(filepath, future);
+    return future;
+}
+
+void GltfLoader::StartLoad(const std::string& filepath,
+                           const std::shared_ptr<std::promise<AssetLoadResult>>& promise) {
     try {
-        // Check if model is already loaded
+        m_threadPool->Enqueue([this, filepath, promise]() { promise->set_value(RunLoad(filepath)); });
+    } catch (const std::exception& e) {
+        // Unregister the load so a later request can retry it
+        AssetLoadResult result;
+        result.errorMessage = "Failed to queue model load: " + std::string(e.what());
+        std::vector<ModelRequestId> requests;
         {
             std::lock_guard<std::mutex> lock(m_modelsMutex);
-            auto it = m_loadedModels.find(filepath);
-            if (it != m_loadedModels.end()) {
-                result.model = it->second;
-                result.success = true;
-                return result;
+            m_inFlightLoads.erase(filepath);
+            auto waiting = m_loadRequests.find(filepath);
+            if (waiting != m_loadRequests.end()) {
+                requests = std::move(waiting->second);
+                m_loadRequests.erase(waiting);
             }
         }
+        CompleteRequests(filepath, requests, result);
+        promise->set_value(result);
+    }
+}
 
+AssetLoadResult GltfLoader::RunLoad(const std::string& filepath) {
+    AssetLoadResult result;
+    
+    try {
         // Parse glTF file
         result = ParseGltfFile(filepath);
-        if (!result.success) {
-            return result;
-        }
-
-        // Store loaded model
-        {
-            std::lock_guard<std::mutex> lock(m_modelsMutex);
-            m_loadedModels[filepath] = result.model;
+        if (!result.success && result.model) {
+            DestroyModelResources(*result.model);
         }
-
-        std::cout << "Successfully loaded model: " << filepath << std::endl;
-        return result;
-        
     } catch (const std::exception& e) {
         result.success = false;
         result.errorMessage = "Exception during model loading: " + std::string(e.what());
         std::cerr << result.errorMessage << std::endl;
-        return result;
+    }
+
+    // Publishing and leaving the in-flight table happen under one lock, so
+    // a concurrent request either joins this load or finds the model
+    std::vector<ModelRequestId> requests;
+    {
+        std::lock_guard<std::mutex> lock(m_modelsMutex);
+        if (result.success) {
+            StoreModel(filepath, result.model, true);
+        }
+        m_inFlightLoads.erase(filepath);
+        auto waiting = m_loadRequests.find(filepath);
+        if (waiting != m_loadRequests.end()) {
+            requests = std::move(waiting->second);
+            m_loadRequests.erase(waiting);
+        }
+    }
+    CompleteRequests(filepath, requests, result);
+
+    if (result.success) {
+        std::cout << "Successfully loaded model: " << filepath << std::endl;
+    }
+    return result;
+}
+
+void GltfLoader::StoreModel(const std::string& name, const ModelHandle& model, bool reloadable) {
+    auto existing = m_loadedModels.find(name);
+    if (existing != m_loadedModels.end()) {
+        RemoveModel(existing);
+    }
+
+    LoadedModel& entry = m_loadedModels[name];
+    entry.model = model;
+    entry.reloadable = reloadable;
+    m_residentBytes += model->residentBytes;
+    if (!model->isLoaded) {
+        m_pendingModels.push_back(model);
     }
 }
 
+void GltfLoader::RemoveModel(std::unordered_map<std::string, LoadedModel>::iterator it) {
+    auto& model = it->second.model;
+    if (model) {
+        m_pendingModels.erase(std::remove(m_pendingModels.begin(), m_pendingModels.end(), model),
+                              m_pendingModels.end());
+        m_residentBytes -= model->residentBytes;
+        DestroyModelResources(*model);
+    }
+    m_loadedModels.erase(it);
+}
+
 AssetLoadResult GltfLoader::CreateCubeModel() {
     AssetLoadResult result;
     result.model = std::make_shared<Model>();
@@ -258,58 +956,27 @@ AssetLoadResult GltfLoader::CreateCubeModel() {
             4, 5, 1,  1, 0, 4
         };
         
-        cubeMesh.vertices = cubeVertices;
-        cubeMesh.indices = cubeIndices;
-        cubeMesh.materialIndex = 0;
-        cubeMesh.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        Submesh cubeSubmesh;
+        cubeSubmesh.indexCount = static_cast<uint32_t>(cubeIndices.size());
+        cubeSubmesh.materialIndex = 0;
+        cubeSubmesh.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        cubeMesh.submeshes.push_back(cubeSubmesh);
         
-        // Create vertex buffer
-        VkBufferCreateInfo vertexBufferInfo{};
-        vertexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        vertexBufferInfo.size = sizeof(Vertex) * cubeMesh.vertices.size();
-        vertexBufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        vertexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        VmaAllocationCreateInfo vertexAllocInfo = {};
-        vertexAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-        vertexAllocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-
-        if (!m_transferManager->CreateBuffer(vertexBufferInfo, vertexAllocInfo, 
-                                           cubeMesh.vertexBuffer, cubeMesh.vertexBufferAllocation)) {
-            result.success = false;
-            result.errorMessage = "Failed to create vertex buffer for cube";
-            return result;
-        }
-
-        if (!m_transferManager->UploadBufferData(cubeMesh.vertexBuffer, cubeMesh.vertexBufferAllocation,
-                                               cubeMesh.vertices.data(), sizeof(Vertex) * cubeMesh.vertices.size())) {
+        // Sub-allocate from the geometry arena and stage the data into it
+        TransferBatch uploadBatch = m_transferManager->BeginBatch();
+        cubeMesh.geometry = m_geometryArena->Allocate(cubeVertices.data(), static_cast<uint32_t>(cubeVertices.size()),
+                                                      cubeIndices.data(), static_cast<uint32_t>(cubeIndices.size()),
+                                                      uploadBatch);
+        if (cubeMesh.geometry == kInvalidGeometryHandle) {
             result.success = false;
-            result.errorMessage = "Failed to upload vertex data for cube";
+            result.errorMessage = "Failed to allocate geometry for cube";
             return result;
         }
 
-        // Create index buffer
-        VkBufferCreateInfo indexBufferInfo{};
-        indexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        indexBufferInfo.size = sizeof(uint32_t) * cubeMesh.indices.size();
-        indexBufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        indexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        VmaAllocationCreateInfo indexAllocInfo = {};
-        indexAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-        indexAllocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-
-        if (!m_transferManager->CreateBuffer(indexBufferInfo, indexAllocInfo,
-                                           cubeMesh.indexBuffer, cubeMesh.indexBufferAllocation)) {
+        if (!m_transferManager->CommitBatch(uploadBatch, result.model->uploadTicket)) {
+            m_geometryArena->Free(cubeMesh.geometry);
             result.success = false;
-            result.errorMessage = "Failed to create index buffer for cube";
-            return result;
-        }
-
-        if (!m_transferManager->UploadBufferData(cubeMesh.indexBuffer, cubeMesh.indexBufferAllocation,
-                                               cubeMesh.indices.data(), sizeof(uint32_t) * cubeMesh.indices.size())) {
-            result.success = false;
-            result.errorMessage = "Failed to upload index data for cube";
+            result.errorMessage = "Failed to upload cube geometry";
             return result;
         }
         
@@ -327,14 +994,18 @@ AssetLoadResult GltfLoader::CreateCubeModel() {
         result.model->rootNode = std::make_unique<Node>();
         result.model->rootNode->name = "Cube";
         result.model->rootNode->meshIndices.push_back(0);
+        result.model->residentBytes = cubeVertices.size() * sizeof(Vertex) + cubeIndices.size() * sizeof(uint32_t);
         
-        result.model->isLoaded = true;
+        result.model->isLoaded = !result.model->uploadTicket.IsValid();
+        if (result.model->isLoaded) {
+            MarkGeometryResident(*result.model);
+        }
         result.success = true;
         
         // Store the model
         {
             std::lock_guard<std::mutex> lock(m_modelsMutex);
-            m_loadedModels["cube"] = result.model;
+            StoreModel("cube", result.model, false);
         }
         
         std::cout << "Successfully created cube model programmatically" << std::endl;
@@ -348,11 +1019,11 @@ AssetLoadResult GltfLoader::CreateCubeModel() {
     }
 }
 
-std::shared_ptr<Model> GltfLoader::GetModel(const std::string& name) {
+ModelHandle GltfLoader::GetModel(const std::string& name) {
     std::lock_guard<std::mutex> lock(m_modelsMutex);
     auto it = m_loadedModels.find(name);
     if (it != m_loadedModels.end()) {
-        return it->second;
+        return it->second.model;
     }
     return nullptr;
 }
@@ -362,44 +1033,230 @@ bool GltfLoader::IsModelLoaded(const std::string& name) {
     return m_loadedModels.find(name) != m_loadedModels.end();
 }
 
+void GltfLoader::UpdatePendingUploads() {
+    if (!m_transferManager) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_modelsMutex);
+    auto it = m_pendingModels.begin();
+    while (it != m_pendingModels.end()) {
+        if (m_transferManager->IsComplete((*it)->uploadTicket)) {
+            MarkGeometryResident(**it);
+            (*it)->isLoaded = true;
+            it = m_pendingModels.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Reloads replace the contents of the original Model here, on the render
+    // thread, so handles stay valid and draws never see a half-swapped model
+    auto reloaded = m_reloadedModels.begin();
+    while (reloaded != m_reloadedModels.end()) {
+        Model& source = *reloaded->model;
+        if (!m_transferManager->IsComplete(source.uploadTicket)) {
+            ++reloaded;
+            continue;
+        }
+
+        auto entry = m_loadedModels.find(reloaded->name);
+        if (entry == m_loadedModels.end() || !entry->second.evicted) {
+            // Unloaded while the reload ran
+            DestroyModelResources(source);
+        } else {
+            Model& target = *entry->second.model;
+            target.meshes = std::move(source.meshes);
+            target.materials = std::move(source.materials);
+            target.textures = std::move(source.textures);
+            target.rootNode = std::move(source.rootNode);
+            target.skeleton = std::move(source.skeleton);
+            target.skins = std::move(source.skins);
+            target.skinBindings = std::move(source.skinBindings);
+            target.animations = std::move(source.animations);
+            target.uploadTicket = source.uploadTicket;
+            target.residentBytes = source.residentBytes;
+            target.textureBytes = source.textureBytes;
+            MarkGeometryResident(target);
+            target.isLoaded = true;
+            m_residentBytes += target.residentBytes;
+            entry->second.evicted = false;
+            entry->second.reloading = false;
+            std::cout << "Reloaded evicted model: " << reloaded->name << std::endl;
+        }
+        reloaded = m_reloadedModels.erase(reloaded);
+    }
+}
+
 void GltfLoader::UnloadModel(const std::string& name) {
     std::lock_guard<std::mutex> lock(m_modelsMutex);
     auto it = m_loadedModels.find(name);
     if (it != m_loadedModels.end()) {
-        // Cleanup model resources
-        auto& model = it->second;
-        if (model) {
-            for (auto& mesh : model->meshes) {
-                if (mesh.vertexBuffer != VK_NULL_HANDLE) {
-                    vkDestroyBuffer(m_device, mesh.vertexBuffer, nullptr);
-                }
-                if (mesh.indexBuffer != VK_NULL_HANDLE) {
-                    vkDestroyBuffer(m_device, mesh.indexBuffer, nullptr);
-                }
-                if (mesh.vertexBufferAllocation != VK_NULL_HANDLE) {
-                    vmaFreeMemory(m_allocator, mesh.vertexBufferAllocation);
-                }
-                if (mesh.indexBufferAllocation != VK_NULL_HANDLE) {
-                    vmaFreeMemory(m_allocator, mesh.indexBufferAllocation);
-                }
-            }
-            
-            for (auto& material : model->materials) {
-                if (material.baseColorTexture != VK_NULL_HANDLE) {
-                    vkDestroyImage(m_device, material.baseColorTexture, nullptr);
-                }
-                if (material.baseColorTextureView != VK_NULL_HANDLE) {
-                    vkDestroyImageView(m_device, material.baseColorTextureView, nullptr);
-                }
-                if (material.baseColorSampler != VK_NULL_HANDLE) {
-                    vkDestroySampler(m_device, material.baseColorSampler, nullptr);
-                }
-                if (material.baseColorTextureAllocation != VK_NULL_HANDLE) {
-                    vmaFreeMemory(m_allocator, material.baseColorTextureAllocation);
-                }
-            }
+        RemoveModel(it);
+    }
+}
+
+VkDeviceSize GltfLoader::GetResidentBytes() {
+    std::lock_guard<std::mutex> lock(m_modelsMutex);
+    return m_residentBytes;
+}
+
+bool GltfLoader::EvictModel(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_modelsMutex);
+    auto it = m_loadedModels.find(name);
+    if (it == m_loadedModels.end() || it->second.evicted || !it->second.reloadable) {
+        return false;
+    }
+
+    ModelHandle& model = it->second.model;
+    if (std::find(m_pendingModels.begin(), m_pendingModels.end(), model) != m_pendingModels.end()) {
+        return false;
+    }
+
+    model->isLoaded = false;
+    DestroyModelResources(*model);
+    model->meshes.clear();
+    model->textures.clear();
+    m_residentBytes -= model->residentBytes;
+    model->residentBytes = 0;
+    model->textureBytes = 0;
+    it->second.evicted = true;
+    return true;
+}
+
+void GltfLoader::ReloadModel(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(m_modelsMutex);
+        auto it = m_loadedModels.find(name);
+        if (it == m_loadedModels.end() || !it->second.evicted || it->second.reloading || !m_threadPool) {
+            return;
+        }
+        it->second.reloading = true;
+    }
+
+    auto reload = [this, name]() {
+        // Usually a warm mesh cache hit, so much cheaper than the first load
+        AssetLoadResult result = ParseGltfFile(name);
+        std::lock_guard<std::mutex> lock(m_modelsMutex);
+        if (result.success) {
+            m_reloadedModels.push_back(ReloadedModel{ name, result.model });
+            return;
+        }
+
+        std::cerr << "Failed to reload model " << name << ": " << result.errorMessage << std::endl;
+        if (result.model) {
+            DestroyModelResources(*result.model);
+        }
+        auto it = m_loadedModels.find(name);
+        if (it != m_loadedModels.end()) {
+            it->second.reloading = false;
+        }
+    };
+
+    try {
+        m_threadPool->Enqueue(reload);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to queue reload of " << name << ": " << e.what() << std::endl;
+        std::lock_guard<std::mutex> lock(m_modelsMutex);
+        auto it = m_loadedModels.find(name);
+        if (it != m_loadedModels.end()) {
+            it->second.reloading = false;
+        }
+    }
+}
+
+bool GltfLoader::IsModelEvicted(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_modelsMutex);
+    auto it = m_loadedModels.find(name);
+    return it != m_loadedModels.end() && it->second.evicted;
+}
+
+std::vector<ModelResidency> GltfLoader::GetResidentModels() {
+    std::lock_guard<std::mutex> lock(m_modelsMutex);
+    std::vector<ModelResidency> models;
+    for (const auto& [name, entry] : m_loadedModels) {
+        if (!entry.evicted) {
+            models.push_back(ModelResidency{ name, entry.model->residentBytes, entry.model->textureBytes });
+        }
+    }
+    return models;
+}
+
+void GltfLoader::DestroyModelResources(Model& model) {
+    // The copies into these resources may still be executing
+    if (m_transferManager) {
+        m_transferManager->Wait(model.uploadTicket);
+    }
+
+    for (auto& mesh : model.meshes) {
+        if (GeometryArena* arena = GetGeometryArena(mesh.vertexFormat)) {
+            arena->Free(mesh.geometry);
+        }
+        mesh.geometry = kInvalidGeometryHandle;
+        if (m_morphArena) {
+            m_morphArena->Free(mesh.morphGeometry);
+        }
+        mesh.morphGeometry = kInvalidGeometryHandle;
+    }
+
+    // Frames already recorded may still sample the textures
+    std::lock_guard<std::mutex> lock(m_retiredTexturesMutex);
+    for (auto& texture : model.textures) {
+        VkDeviceSize bytes = 0;
+        if (texture.allocation != VK_NULL_HANDLE) {
+            VmaAllocationInfo allocationInfo;
+            vmaGetAllocationInfo(m_allocator, texture.allocation, &allocationInfo);
+            bytes = allocationInfo.size;
+        }
+        m_retiredTextures.push_back(RetiredTexture{ texture, bytes, m_framesInFlight });
+        m_retiredTextureBytes += bytes;
+        texture = Texture{};
+    }
+}
+
+void GltfLoader::DestroyTexture(Texture& texture) {
+    if (texture.sampler != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
+        vkDestroySampler(m_device, texture.sampler, nullptr);
+        texture.sampler = VK_NULL_HANDLE;
+    }
+    if (texture.view != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
+        vkDestroyImageView(m_device, texture.view, nullptr);
+        texture.view = VK_NULL_HANDLE;
+    }
+    if (texture.image != VK_NULL_HANDLE && m_allocator != VK_NULL_HANDLE) {
+        vmaDestroyImage(m_allocator, texture.image, texture.allocation);
+        texture.image = VK_NULL_HANDLE;
+        texture.allocation = VK_NULL_HANDLE;
+    }
+}
+
+void GltfLoader::BeginFrame() {
+    std::lock_guard<std::mutex> lock(m_retiredTexturesMutex);
+    auto retired = m_retiredTextures.begin();
+    while (retired != m_retiredTextures.end()) {
+        if (retired->framesLeft == 0) {
+            DestroyTexture(retired->texture);
+            m_retiredTextureBytes -= retired->bytes;
+            retired = m_retiredTextures.erase(retired);
+        } else {
+            retired->framesLeft--;
+            ++retired;
+        }
+    }
+}
+
+VkDeviceSize GltfLoader::GetRetiredTextureBytes() {
+    std::lock_guard<std::mutex> lock(m_retiredTexturesMutex);
+    return m_retiredTextureBytes;
+}
+
+void GltfLoader::MarkGeometryResident(const Model& model) {
+    // Lets the arena compact ranges whose uploads have landed
+    for (const auto& mesh : model.meshes) {
+        GetGeometryArena(mesh.vertexFormat)->MarkResident(mesh.geometry);
+        if (mesh.morphGeometry != kInvalidGeometryHandle) {
+            m_morphArena->MarkResident(mesh.morphGeometry);
         }
-        m_loadedModels.erase(it);
     }
 }
 
@@ -409,18 +1266,60 @@ AssetLoadResult GltfLoader::ParseGltfFile(const std::string& filepath) {
     result.model->name = filepath;
 
     try {
+        // The source stays mapped for the whole load: the cache key is hashed
+        // from the mapping, and a GLB's BIN chunk is cooked from it in place
+        MappedFile sourceFile;
+        if (!sourceFile.Open(filepath)) {
+            result.success = false;
+            result.errorMessage = "Failed to read glTF file: " + filepath;
+            return result;
+        }
+
+        // A cooked entry for this exact source skips tinygltf and all vertex
+        // processing. The mapping must stay open until the batch is committed.
+        uint64_t sourceHash = 0;
+        bool cacheable = m_meshCache != nullptr;
+        if (cacheable) {
+            sourceHash = MeshCache::HashBytes(sourceFile.GetData(), sourceFile.GetSize());
+            // Packing settings decide the cooked vertex layout, so they are part of the key
+            float tolerance = m_assetConfig.packVertices ? m_assetConfig.packedPositionTolerance : -1.0f;
+            sourceHash ^= MeshCache::HashBytes(reinterpret_cast<const unsigned char*>(&tolerance), sizeof(tolerance));
+        }
+        if (cacheable) {
+            MappedFile cacheFile;
+            CookedModel cooked;
+            if (m_meshCache->Read(sourceHash, cacheFile, cooked)) {
+                std::vector<DecodedImage> decodedImages;
+                AssetTaskGroup tasks(GetTaskPool());
+                DecodeImages(cooked, decodedImages, tasks);
+                tasks.Wait();
+                BuildModel(cooked, decodedImages, result);
+                return result;
+            }
+        }
+
         tinygltf::Model gltfModel;
         tinygltf::TinyGLTF loader;
         std::string err;
         std::string warn;
 
-        bool ret = false;
-        if (filepath.find(".glb") != std::string::npos) {
-            ret = loader.LoadBinaryFromFile(&gltfModel, &err, &warn, filepath);
-        } else {
-            ret = loader.LoadASCIIFromFile(&gltfModel, &err, &warn, filepath);
+        // Images stay encoded here and are decoded in parallel in DecodeImages
+        EncodedImages encodedImages;
+        loader.SetImageLoader(&GltfLoader::KeepEncodedImage, &encodedImages);
+
+        // tinygltf only ever sees the JSON; for a GLB the BIN chunk stays in the mapping
+        bool binary = filepath.find(".glb") != std::string::npos;
+        PreparedGltf prepared;
+        if (!PrepareGltf(sourceFile.GetData(), sourceFile.GetSize(), binary, prepared, result.errorMessage)) {
+            result.success = false;
+            result.errorMessage += ": " + filepath;
+            return result;
         }
 
+        std::string baseDir = std::filesystem::path(filepath).parent_path().string();
+        bool ret = loader.LoadASCIIFromString(&gltfModel, &err, &warn, prepared.json.data(),
+                                              static_cast<unsigned int>(prepared.json.size()), baseDir);
+
         if (!warn.empty()) {
             std::cout << "glTF warning: " << warn << std::endl;
         }
@@ -437,29 +1336,81 @@ AssetLoadResult GltfLoader::ParseGltfFile(const std::string& filepath) {
             return result;
         }
 
-        // Load materials first (needed for meshes)
-        if (!LoadMaterials(gltfModel, *result.model)) {
+        // Draco primitives only load through their uncompressed fallback
+        const auto& required = gltfModel.extensionsRequired;
+        if (std::find(required.begin(), required.end(), kDracoExtension) != required.end()) {
             result.success = false;
-            result.errorMessage = "Failed to load materials";
+            result.errorMessage = std::string(kDracoExtension) + " is required by " + filepath +
+                                  " but not supported; re-export with EXT_meshopt_compression";
             return result;
         }
 
-        // Load meshes
-        if (!LoadMeshes(gltfModel, *result.model)) {
+        // Buffer and image bytes for the rest of the load
+        GltfBuffers buffers;
+        buffers.spans.resize(gltfModel.buffers.size());
+        for (size_t i = 0; i < gltfModel.buffers.size(); i++) {
+            const auto& data = gltfModel.buffers[i].data;
+            buffers.spans[i] = static_cast<int>(i) == prepared.binBuffer ? prepared.bin
+                                                                         : BufferSpan{ data.data(), data.size() };
+        }
+        encodedImages.images.resize(gltfModel.images.size());
+        for (size_t i = 0; i < encodedImages.copies.size() && i < encodedImages.images.size(); i++) {
+            encodedImages.images[i] = BufferSpan{ encodedImages.copies[i].data(), encodedImages.copies[i].size() };
+        }
+        for (const auto& [image, view] : prepared.binImages) {
+            const auto& bufferView = gltfModel.bufferViews[view];
+            if (static_cast<size_t>(image) < encodedImages.images.size() &&
+                bufferView.byteOffset <= prepared.bin.size &&
+                bufferView.byteLength <= prepared.bin.size - bufferView.byteOffset) {
+                encodedImages.images[image] = BufferSpan{ prepared.bin.data + bufferView.byteOffset,
+                                                          bufferView.byteLength };
+            }
+        }
+
+        if (!DecodeCompressedBufferViews(gltfModel, buffers, result.errorMessage)) {
             result.success = false;
-            result.errorMessage = "Failed to load meshes";
             return result;
         }
 
-        // Load nodes
-        if (!LoadNodes(gltfModel, *result.model)) {
+        CookedModel cooked;
+        cooked.sourceHash = sourceHash;
+        CookedGeometry geometry;
+
+        // Load materials first; they decide which images are decoded
+        if (!LoadMaterials(gltfModel, encodedImages, cooked)) {
             result.success = false;
-            result.errorMessage = "Failed to load nodes";
+            result.errorMessage = "Failed to load materials";
             return result;
         }
 
-        result.model->isLoaded = true;
-        result.success = true;
+        // Image decodes, mesh cooking and node flattening (with the skins and
+        // animations that refer to nodes) are independent, so they all run as
+        // tasks of one group and a single large model keeps every worker busy.
+        // Uploads start once all of them are done.
+        std::vector<DecodedImage> decodedImages;
+        {
+            AssetTaskGroup tasks(GetTaskPool());
+            DecodeImages(cooked, decodedImages, tasks);
+            LoadMeshes(gltfModel, buffers, cooked, geometry, tasks);
+            tasks.Run([this, &gltfModel, &buffers, &cooked]() {
+                // Skins and animations address nodes by their flattened index
+                std::vector<int32_t> nodeIndices;
+                LoadNodes(gltfModel, cooked, nodeIndices);
+                LoadSkins(gltfModel, buffers, nodeIndices, cooked);
+                LoadAnimations(gltfModel, buffers, nodeIndices, cooked);
+            });
+            tasks.Wait();
+        }
+        LogVertexCacheStats(cooked);
+
+        if (!BuildModel(cooked, decodedImages, result)) {
+            return result;
+        }
+
+        // A failed write only costs the next load its warm path
+        if (cacheable && LoadDependencies(gltfModel, filepath, cooked)) {
+            m_meshCache->Write(cooked);
+        }
         return result;
 
     } catch (const std::exception& e) {
@@ -469,233 +1420,978 @@ AssetLoadResult GltfLoader::ParseGltfFile(const std::string& filepath) {
     }
 }
 
-bool GltfLoader::LoadMaterials(const tinygltf::Model& gltfModel, Model& model) {
-    model.materials.resize(gltfModel.materials.size());
+bool GltfLoader::DecodeCompressedBufferViews(tinygltf::Model& gltfModel, GltfBuffers& buffers, std::string& error) {
+    struct CompressedView {
+        size_t bufferView;
+        size_t buffer;
+        size_t byteOffset;
+        size_t byteLength;
+        size_t count;
+        size_t stride;
+        MeshoptMode mode;
+        MeshoptFilter filter;
+        std::string error;
+    };
+
+    std::vector<CompressedView> views;
+    for (size_t i = 0; i < gltfModel.bufferViews.size(); i++) {
+        auto extension = gltfModel.bufferViews[i].extensions.find(kMeshoptExtension);
+        if (extension == gltfModel.bufferViews[i].extensions.end()) {
+            continue;
+        }
+
+        // Sizes arrive as JSON doubles; anything but a whole number a double
+        // represents exactly is rejected before it is converted
+        const tinygltf::Value& value = extension->second;
+        auto getSize = [&value](const char* key, bool required, size_t& size) -> bool {
+            size = 0;
+            if (!value.Has(key)) {
+                return !required;
+            }
+            const tinygltf::Value& number = value.Get(key);
+            if (!number.IsNumber()) {
+                return false;
+            }
+            double n = number.GetNumberAsDouble();
+            if (!(n >= 0.0 && n <= 9007199254740992.0) || std::floor(n) != n) {
+                return false;
+            }
+            size = static_cast<size_t>(n);
+            return true;
+        };
+        CompressedView view{};
+        view.bufferView = i;
+        view.filter = MeshoptFilter::None;
+        bool valid = getSize("buffer", true, view.buffer) && getSize("byteOffset", false, view.byteOffset) &&
+                     getSize("byteLength", true, view.byteLength) && getSize("count", true, view.count) &&
+                     getSize("byteStride", true, view.stride);
+        valid = valid && value.Has("mode") && ParseMeshoptMode(value.Get("mode").Get<std::string>(), view.mode) &&
+                (!value.Has("filter") || ParseMeshoptFilter(value.Get("filter").Get<std::string>(), view.filter));
+        valid = valid && view.buffer < buffers.spans.size() && view.byteOffset <= buffers.spans[view.buffer].size &&
+                view.byteLength <= buffers.spans[view.buffer].size - view.byteOffset;
+
+        // The decoders write count elements of stride bytes, which must be
+        // exactly what the view declares its accessors read
+        valid = valid && view.stride > 0 && view.count <= std::numeric_limits<size_t>::max() / view.stride &&
+                view.count * view.stride == gltfModel.bufferViews[i].byteLength;
+        if (!valid) {
+            error = "Invalid " + std::string(kMeshoptExtension) + " in buffer view " + std::to_string(i);
+            return false;
+        }
+        views.push_back(std::move(view));
+    }
+    if (views.empty()) {
+        return true;
+    }
+
+    // Each view decodes into a buffer of its own, allocated before any task
+    // starts. The views are then repointed, so the attribute decoders read
+    // the decoded bytes in place.
+    auto start = std::chrono::steady_clock::now();
+    size_t firstBuffer = buffers.spans.size();
+    buffers.decoded.resize(views.size());
+    for (size_t i = 0; i < views.size(); i++) {
+        buffers.decoded[i].resize(views[i].count * views[i].stride);
+        buffers.spans.push_back(BufferSpan{ buffers.decoded[i].data(), buffers.decoded[i].size() });
+    }
+
+    AssetTaskGroup decodes(GetTaskPool());
+    for (size_t i = 0; i < views.size(); i++) {
+        decodes.Run([&source = buffers.spans[views[i].buffer], &view = views[i], &target = buffers.decoded[i]]() {
+            DecodeMeshoptBufferView(source.data + view.byteOffset, view.byteLength, view.count, view.stride,
+                                    view.mode, view.filter, target.data(), view.error);
+        });
+    }
+    decodes.Wait();
+
+    size_t compressedBytes = 0;
+    size_t decodedBytes = 0;
+    for (size_t i = 0; i < views.size(); i++) {
+        const auto& view = views[i];
+        if (!view.error.empty()) {
+            error = "Failed to decode buffer view " + std::to_string(view.bufferView) + ": " + view.error;
+            return false;
+        }
+        auto& bufferView = gltfModel.bufferViews[view.bufferView];
+        bufferView.buffer = static_cast<int>(firstBuffer + i);
+        bufferView.byteOffset = 0;
+        compressedBytes += view.byteLength;
+        decodedBytes += bufferView.byteLength;
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "Decoded " << views.size() << " meshopt buffer views, " << compressedBytes / 1024 << " KB -> "
+              << decodedBytes / 1024 << " KB in " << elapsed.count() << " ms" << std::endl;
+    return true;
+}
+
+bool GltfLoader::BuildModel(const CookedModel& cooked, const std::vector<DecodedImage>& decodedImages,
+                            AssetLoadResult& result) {
+    Model& model = *result.model;
+    result.success = false;
+
+    // All of the model's uploads go out as one batch
+    TransferBatch uploadBatch = m_transferManager->BeginBatch();
+
+    model.materials = cooked.materials;
+
+    // Decoded pixels are read when the batch is committed below
+    if (!LoadTextures(cooked, model, decodedImages, uploadBatch)) {
+        result.errorMessage = "Failed to load textures";
+        return false;
+    }
+
+    // Sub-allocate from the geometry arena of each mesh's vertex format and
+    // stage the data into it
+    model.meshes.resize(cooked.meshes.size());
+    for (size_t i = 0; i < cooked.meshes.size(); i++) {
+        const auto& cookedMesh = cooked.meshes[i];
+        auto& mesh = model.meshes[i];
+        mesh.submeshes = cookedMesh.submeshes;
+        if (cookedMesh.vertexCount == 0 || cookedMesh.indexCount == 0) {
+            continue;
+        }
+
+        GeometryArena* arena = GetGeometryArena(cookedMesh.vertexFormat);
+        if (!arena) {
+            std::cerr << "Mesh " << i << " is packed but vertex packing is disabled" << std::endl;
+            result.errorMessage = "Failed to load meshes";
+            return false;
+        }
+
+        mesh.vertexFormat = cookedMesh.vertexFormat;
+        mesh.positionOffset = cookedMesh.positionOffset;
+        mesh.positionScale = cookedMesh.positionScale;
+        mesh.jointCount = cookedMesh.jointCount;
+        mesh.sourceCacheStats = cookedMesh.sourceCacheStats;
+        mesh.cacheStats = cookedMesh.cacheStats;
+        mesh.geometry = arena->Allocate(cookedMesh.vertices, cookedMesh.vertexCount,
+                                        cookedMesh.indices, cookedMesh.indexCount, uploadBatch);
+        if (mesh.geometry == kInvalidGeometryHandle) {
+            std::cerr << "Failed to allocate geometry for mesh " << i << std::endl;
+            result.errorMessage = "Failed to load meshes";
+            return false;
+        }
+        model.residentBytes += static_cast<VkDeviceSize>(cookedMesh.vertexCount) *
+                                   GetVertexStride(cookedMesh.vertexFormat) +
+                               static_cast<VkDeviceSize>(cookedMesh.indexCount) * sizeof(uint32_t);
+
+        if (cookedMesh.morphDeltaCount == 0) {
+            continue;
+        }
+        mesh.morphTargetCount = cookedMesh.morphTargetCount;
+        mesh.morphGeometry = m_morphArena->Allocate(cookedMesh.morphDeltas, cookedMesh.morphDeltaCount,
+                                                    cookedMesh.morphOffsets, cookedMesh.vertexCount + 1,
+                                                    uploadBatch);
+        if (mesh.morphGeometry == kInvalidGeometryHandle) {
+            std::cerr << "Failed to allocate morph targets for mesh " << i << std::endl;
+            result.errorMessage = "Failed to load meshes";
+            return false;
+        }
+        model.residentBytes += static_cast<VkDeviceSize>(cookedMesh.morphDeltaCount) * sizeof(MorphDelta) +
+                               static_cast<VkDeviceSize>(cookedMesh.vertexCount + 1) * sizeof(uint32_t);
+    }
+
+    // Textures count with their allocation size, which includes mips and padding
+    for (const auto& texture : model.textures) {
+        if (texture.allocation != VK_NULL_HANDLE) {
+            VmaAllocationInfo allocationInfo;
+            vmaGetAllocationInfo(m_allocator, texture.allocation, &allocationInfo);
+            model.residentBytes += allocationInfo.size;
+            model.textureBytes += allocationInfo.size;
+        }
+    }
+
+    BuildNodes(cooked, model);
+
+    // The model becomes loaded when the batch retires (see UpdatePendingUploads)
+    if (!m_transferManager->CommitBatch(uploadBatch, model.uploadTicket)) {
+        result.errorMessage = "Failed to upload model data";
+        return false;
+    }
+
+    model.isLoaded = !model.uploadTicket.IsValid();
+    if (model.isLoaded) {
+        MarkGeometryResident(model);
+    }
+    result.success = true;
+    return true;
+}
+
+bool GltfLoader::LoadMaterials(const tinygltf::Model& gltfModel, const EncodedImages& encodedImages,
+                               CookedModel& cooked) {
+    cooked.materials.resize(gltfModel.materials.size());
+
+    // Images are added as textures reference them, so unused ones are neither
+    // decoded nor cooked
+    std::unordered_map<int, int32_t> imageIndices;
+    auto addImage = [&](int source) -> int32_t {
+        if (source < 0 || source >= static_cast<int>(gltfModel.images.size())) {
+            return -1;
+        }
+        auto [it, inserted] = imageIndices.try_emplace(source, static_cast<int32_t>(cooked.images.size()));
+        if (inserted) {
+            CookedImage image;
+            if (source < static_cast<int>(encodedImages.images.size())) {
+                image.data = encodedImages.images[source].data;
+                image.size = encodedImages.images[source].size;
+            }
+            image.name = gltfModel.images[source].name;
+            cooked.images.push_back(image);
+        }
+        return it->second;
+    };
+
+    // Color slots sample as sRGB, data slots (normals, ORM) as linear. The same
+    // glTF texture can be needed in both color spaces, so textures are keyed by
+    // texture and format.
+    std::vector<std::pair<int, VkFormat>> requested;
+    auto requestTexture = [&](int textureIndex, VkFormat format) -> int {
+        if (textureIndex < 0 || textureIndex >= static_cast<int>(gltfModel.textures.size())) {
+            return -1;
+        }
+        for (size_t i = 0; i < requested.size(); i++) {
+            if (requested[i].first == textureIndex && requested[i].second == format) {
+                return static_cast<int>(i);
+            }
+        }
+
+        const auto& gltfTexture = gltfModel.textures[textureIndex];
+        // KHR_texture_basisu sources are BasisLZ or UASTC, which need a
+        // transcoder this build does not have, so textures always use their
+        // source. KTX2 images it names directly load pre-transcoded.
+        int source = gltfTexture.source;
+
+        CookedTexture texture;
+        texture.image = addImage(source);
+        texture.format = format;
+        if (gltfTexture.sampler >= 0 && gltfTexture.sampler < static_cast<int>(gltfModel.samplers.size())) {
+            const auto& sampler = gltfModel.samplers[gltfTexture.sampler];
+            texture.magFilter = sampler.magFilter;
+            texture.minFilter = sampler.minFilter;
+            texture.wrapS = sampler.wrapS;
+            texture.wrapT = sampler.wrapT;
+        }
+        cooked.textures.push_back(texture);
+        requested.emplace_back(textureIndex, format);
+        return static_cast<int>(cooked.textures.size() - 1);
+    };
 
     for (size_t i = 0; i < gltfModel.materials.size(); i++) {
         const auto& gltfMaterial = gltfModel.materials[i];
-        auto& material = model.materials[i];
+        const auto& pbr = gltfMaterial.pbrMetallicRoughness;
+        auto& material = cooked.materials[i];
 
         // Load base color factor
-        if (gltfMaterial.pbrMetallicRoughness.baseColorFactor.size() >= 4) {
+        if (pbr.baseColorFactor.size() >= 4) {
             material.baseColorFactor = glm::vec4(
-                static_cast<float>(gltfMaterial.pbrMetallicRoughness.baseColorFactor[0]),
-                static_cast<float>(gltfMaterial.pbrMetallicRoughness.baseColorFactor[1]),
-                static_cast<float>(gltfMaterial.pbrMetallicRoughness.baseColorFactor[2]),
-                static_cast<float>(gltfMaterial.pbrMetallicRoughness.baseColorFactor[3])
+                static_cast<float>(pbr.baseColorFactor[0]),
+                static_cast<float>(pbr.baseColorFactor[1]),
+                static_cast<float>(pbr.baseColorFactor[2]),
+                static_cast<float>(pbr.baseColorFactor[3])
             );
         }
 
         // Load metallic and roughness factors
-        material.metallicFactor = static_cast<float>(gltfMaterial.pbrMetallicRoughness.metallicFactor);
-        material.roughnessFactor = static_cast<float>(gltfMaterial.pbrMetallicRoughness.roughnessFactor);
-
-        // Load base color texture
-        if (gltfMaterial.pbrMetallicRoughness.baseColorTexture.index >= 0) {
-            const auto& texture = gltfModel.textures[gltfMaterial.pbrMetallicRoughness.baseColorTexture.index];
-            if (texture.source >= 0 && texture.source < gltfModel.images.size()) {
-                const auto& image = gltfModel.images[texture.source];
-                if (!CreateTextureFromImage(image, material)) {
-                    std::cerr << "Failed to create texture for material " << i << std::endl;
-                    return false;
-                }
-            }
+        material.metallicFactor = static_cast<float>(pbr.metallicFactor);
+        material.roughnessFactor = static_cast<float>(pbr.roughnessFactor);
+
+        // Texture slots; the images themselves are created in LoadTextures
+        material.baseColorTexture = requestTexture(pbr.baseColorTexture.index, VK_FORMAT_R8G8B8A8_SRGB);
+        material.metallicRoughnessTexture = requestTexture(pbr.metallicRoughnessTexture.index,
+                                                           VK_FORMAT_R8G8B8A8_UNORM);
+        material.normalTexture = requestTexture(gltfMaterial.normalTexture.index, VK_FORMAT_R8G8B8A8_UNORM);
+        material.occlusionTexture = requestTexture(gltfMaterial.occlusionTexture.index, VK_FORMAT_R8G8B8A8_UNORM);
+        material.emissiveTexture = requestTexture(gltfMaterial.emissiveTexture.index, VK_FORMAT_R8G8B8A8_SRGB);
+    }
+
+    return true;
+}
+
+void GltfLoader::DecodeImages(const CookedModel& cooked, std::vector<DecodedImage>& decodedImages,
+                              AssetTaskGroup& tasks) {
+    // One task per image so a texture-heavy model decodes on every core.
+    // Each image is decoded once, even when used in both color spaces.
+    decodedImages.resize(cooked.images.size());
+    for (size_t i = 0; i < cooked.images.size(); i++) {
+        tasks.Run([image = &cooked.images[i], &decoded = decodedImages[i]]() { decoded = DecodeImage(*image); });
+    }
+}
+
+bool GltfLoader::LoadTextures(const CookedModel& cooked, Model& model, const std::vector<DecodedImage>& decodedImages,
+                              TransferBatch& batch) {
+    model.textures.resize(cooked.textures.size());
+    for (size_t i = 0; i < cooked.textures.size(); i++) {
+        const auto& source = cooked.textures[i];
+        static const DecodedImage missingImage;
+        bool hasImage = source.image >= 0 && source.image < static_cast<int32_t>(decodedImages.size());
+        const DecodedImage& decoded = hasImage ? decodedImages[source.image] : missingImage;
+        if (!CreateTexture(decoded, source, model.textures[i], batch)) {
+            std::cerr << "Failed to create texture " << i << std::endl;
+            return false;
         }
     }
 
     return true;
 }
 
-bool GltfLoader::LoadMeshes(const tinygltf::Model& gltfModel, Model& model) {
-    model.meshes.resize(gltfModel.meshes.size());
+bool GltfLoader::KeepEncodedImage(tinygltf::Image* image, const int imageIndex, std::string* err, std::string* warn,
+                                  int reqWidth, int reqHeight, const unsigned char* bytes, int size, void* userData) {
+    auto* encodedImages = static_cast<EncodedImages*>(userData);
+    if (imageIndex < 0 || !bytes || size <= 0) {
+        if (err) {
+            *err += "Invalid image data for image " + std::to_string(imageIndex) + "\n";
+        }
+        return false;
+    }
+
+    if (encodedImages->copies.size() <= static_cast<size_t>(imageIndex)) {
+        encodedImages->copies.resize(imageIndex + 1);
+    }
+    encodedImages->copies[imageIndex].assign(bytes, bytes + size);
+    return true;
+}
+
+GltfLoader::DecodedImage GltfLoader::DecodeImage(const CookedImage& image) {
+    DecodedImage decoded;
+    if (!image.data || image.size == 0) {
+        return decoded;
+    }
+
+    // KTX2 levels are uploaded as stored, no CPU-side decode
+    if (IsKtx2(image.data, image.size)) {
+        Ktx2Image ktx2;
+        std::string error;
+        if (!ReadKtx2(image.data, image.size, ktx2, error)) {
+            std::cerr << "Failed to read KTX2 image '" << image.name << "': " << error << std::endl;
+            return decoded;
+        }
+        decoded.pixels = std::move(ktx2.data);
+        decoded.width = ktx2.width;
+        decoded.height = ktx2.height;
+        decoded.format = ktx2.format;
+        decoded.mipLevels = ktx2.mipLevels;
+        decoded.levelOffsets = std::move(ktx2.levelOffsets);
+        return decoded;
+    }
+
+    // PNG and JPEG (and anything else stb_image knows), expanded to RGBA8
+    int width = 0;
+    int height = 0;
+    int components = 0;
+    stbi_uc* pixels = stbi_load_from_memory(image.data, static_cast<int>(image.size),
+                                            &width, &height, &components, STBI_rgb_alpha);
+    if (!pixels) {
+        std::cerr << "Failed to decode image '" << image.name << "'" << std::endl;
+        return decoded;
+    }
+
+    decoded.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    decoded.width = static_cast<uint32_t>(width);
+    decoded.height = static_cast<uint32_t>(height);
+    stbi_image_free(pixels);
+    return decoded;
+}
 
+void GltfLoader::LoadMeshes(const tinygltf::Model& gltfModel, const GltfBuffers& buffers, CookedModel& cooked,
+                            CookedGeometry& geometry, AssetTaskGroup& tasks) {
+    cooked.meshes.resize(gltfModel.meshes.size());
+    geometry.vertices.resize(gltfModel.meshes.size());
+    geometry.packedVertices.resize(gltfModel.meshes.size());
+    geometry.skinnedVertices.resize(gltfModel.meshes.size());
+    geometry.morphDeltas.resize(gltfModel.meshes.size());
+    geometry.morphOffsets.resize(gltfModel.meshes.size());
+    geometry.indices.resize(gltfModel.meshes.size());
+
+    // Meshes placed under a skinned node keep their joints and weights.
+    // Morphed meshes go through the skinning pass too, rigidly if unskinned.
+    std::vector<bool> skinnedMeshes(gltfModel.meshes.size(), false);
+    for (const auto& node : gltfModel.nodes) {
+        if (node.mesh >= 0 && node.mesh < static_cast<int>(gltfModel.meshes.size()) &&
+            (node.skin >= 0 || GetMorphTargetCount(gltfModel.meshes[node.mesh]) > 0)) {
+            skinnedMeshes[node.mesh] = true;
+        }
+    }
+
+    // Meshes cook independently, so each is one task; the vertex cache
+    // optimization dominates for large meshes
     for (size_t i = 0; i < gltfModel.meshes.size(); i++) {
-        const auto& gltfMesh = gltfModel.meshes[i];
-        auto& mesh = model.meshes[i];
+        bool skinned = skinnedMeshes[i];
+        tasks.Run([this, &gltfModel, &buffers, &cooked, &geometry, i, skinned]() {
+            CookMesh(gltfModel, buffers, i, skinned, cooked.meshes[i], geometry);
+        });
+    }
+}
 
-        // For simplicity, we'll only load the first primitive of each mesh
-        if (gltfMesh.primitives.empty()) {
+void GltfLoader::CookMesh(const tinygltf::Model& gltfModel, const GltfBuffers& buffers, size_t meshIndex,
+                          bool skinned, CookedMesh& mesh, CookedGeometry& geometry) {
+    const auto& gltfMesh = gltfModel.meshes[meshIndex];
+    auto& vertices = geometry.vertices[meshIndex];
+    auto& skinnedVertices = geometry.skinnedVertices[meshIndex];
+    auto& morphDeltas = geometry.morphDeltas[meshIndex];
+    auto& morphOffsets = geometry.morphOffsets[meshIndex];
+    auto& indices = geometry.indices[meshIndex];
+
+    // Primitives are packed back to back into one allocation; each keeps
+    // its own indices and records where its vertices start
+    std::vector<Vertex> primitiveVertices;
+    std::vector<SkinnedVertex> primitiveSkinnedVertices;
+    std::vector<MorphDelta> primitiveMorphDeltas;
+    std::vector<uint32_t> primitiveMorphOffsets;
+    std::vector<uint32_t> primitiveIndices;
+    for (size_t p = 0; p < gltfMesh.primitives.size(); p++) {
+        const auto& primitive = gltfMesh.primitives[p];
+        if (primitive.attributes.find("POSITION") == primitive.attributes.end()) {
+            std::cerr << "No positions in primitive " << p << " of mesh " << meshIndex << std::endl;
             continue;
         }
 
-        const auto& primitive = gltfMesh.primitives[0];
-        mesh.materialIndex = primitive.material;
-
         // Process vertices
-        ProcessVertices(gltfModel, primitive, mesh.vertices);
-        if (mesh.vertices.empty()) {
-            std::cerr << "No vertices found in mesh " << i << std::endl;
+        ProcessVertices(gltfModel, buffers, primitive, primitiveVertices);
+        if (primitiveVertices.empty()) {
+            std::cerr << "No vertices found in primitive " << p << " of mesh " << meshIndex << std::endl;
             continue;
         }
 
         // Process indices
-        ProcessIndices(gltfModel, primitive, mesh.indices);
-        if (mesh.indices.empty()) {
-            std::cerr << "No indices found in mesh " << i << std::endl;
+        ProcessIndices(gltfModel, buffers, primitive, primitiveIndices);
+        if (primitiveIndices.empty()) {
+            std::cerr << "No indices found in primitive " << p << " of mesh " << meshIndex << std::endl;
             continue;
         }
 
-        // Create vertex buffer
-        VkBufferCreateInfo vertexBufferInfo{};
-        vertexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        vertexBufferInfo.size = sizeof(Vertex) * mesh.vertices.size();
-        vertexBufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        vertexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        VmaAllocationCreateInfo vertexAllocInfo = {};
-        vertexAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-        vertexAllocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        // Primitives share the arena's vertex buffer, so an index past this
+        // primitive's vertices would draw another mesh's data
+        size_t vertexCount = primitiveVertices.size();
+        if (std::any_of(primitiveIndices.begin(), primitiveIndices.end(),
+                        [vertexCount](uint32_t index) { return index >= vertexCount; })) {
+            std::cerr << "Out of range indices in primitive " << p << " of mesh " << meshIndex << std::endl;
+            continue;
+        }
 
-        if (!m_transferManager->CreateBuffer(vertexBufferInfo, vertexAllocInfo, 
-                                           mesh.vertexBuffer, mesh.vertexBufferAllocation)) {
-            std::cerr << "Failed to create vertex buffer for mesh " << i << std::endl;
-            return false;
+        if (skinned) {
+            mesh.jointCount = std::max(mesh.jointCount, ProcessSkinWeights(gltfModel, buffers, primitive,
+                                                                           primitiveVertices,
+                                                                           primitiveSkinnedVertices));
+            mesh.morphTargetCount = std::max(mesh.morphTargetCount,
+                                             ProcessMorphTargets(gltfModel, buffers, primitive,
+                                                                 primitiveVertices.size(), primitiveMorphDeltas,
+                                                                 primitiveMorphOffsets));
         }
 
-        if (!m_transferManager->UploadBufferData(mesh.vertexBuffer, mesh.vertexBufferAllocation,
-                                               mesh.vertices.data(), sizeof(Vertex) * mesh.vertices.size())) {
-            std::cerr << "Failed to upload vertex data for mesh " << i << std::endl;
-            return false;
+        Submesh submesh;
+        submesh.firstIndex = static_cast<uint32_t>(indices.size());
+        submesh.indexCount = static_cast<uint32_t>(primitiveIndices.size());
+        submesh.vertexOffset = static_cast<int32_t>(skinned ? skinnedVertices.size() : vertices.size());
+        submesh.materialIndex = primitive.material;
+        submesh.topology = GetVkPrimitiveTopology(primitive.mode);
+
+        // Triangle lists from DCC tools come in arbitrary order: reorder them
+        // for the post-transform cache and overdraw, then the vertices for fetch
+        if (submesh.topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST && primitiveIndices.size() % 3 == 0) {
+            mesh.sourceCacheStats.Add(AnalyzeVertexCache(primitiveIndices.data(), primitiveIndices.size(),
+                                                         primitiveVertices.size()));
+            // Triangle order only reads positions, so skinned vertices follow
+            // it and only need their own fetch reordering, which their morph
+            // deltas follow in turn
+            if (OptimizeTriangleOrder(primitiveIndices.data(), primitiveIndices.size(), primitiveVertices.data(),
+                                      primitiveVertices.size())) {
+                if (skinned) {
+                    std::vector<uint32_t> order(primitiveSkinnedVertices.size());
+                    std::iota(order.begin(), order.end(), 0u);
+                    if (OptimizeVertexFetch(order, primitiveIndices.data(), primitiveIndices.size())) {
+                        ReorderSkinnedVertices(order, primitiveSkinnedVertices, primitiveMorphDeltas,
+                                               primitiveMorphOffsets);
+                    }
+                } else {
+                    OptimizeVertexFetch(primitiveVertices, primitiveIndices.data(), primitiveIndices.size());
+                }
+            }
+            mesh.cacheStats.Add(AnalyzeVertexCache(primitiveIndices.data(), primitiveIndices.size(),
+                                                   skinned ? primitiveSkinnedVertices.size()
+                                                           : primitiveVertices.size()));
         }
 
-        // Create index buffer
-        VkBufferCreateInfo indexBufferInfo{};
-        indexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        indexBufferInfo.size = sizeof(uint32_t) * mesh.indices.size();
-        indexBufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        indexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        mesh.submeshes.push_back(submesh);
+        if (skinned) {
+            // Offsets become relative to the mesh's deltas; the closing entry
+            // is added once all primitives are in
+            uint32_t deltaBase = static_cast<uint32_t>(morphDeltas.size());
+            for (size_t v = 0; v < primitiveSkinnedVertices.size(); v++) {
+                morphOffsets.push_back(deltaBase + primitiveMorphOffsets[v]);
+            }
+            morphDeltas.insert(morphDeltas.end(), primitiveMorphDeltas.begin(), primitiveMorphDeltas.end());
+            skinnedVertices.insert(skinnedVertices.end(), primitiveSkinnedVertices.begin(),
+                                   primitiveSkinnedVertices.end());
+        } else {
+            vertices.insert(vertices.end(), primitiveVertices.begin(), primitiveVertices.end());
+        }
+        indices.insert(indices.end(), primitiveIndices.begin(), primitiveIndices.end());
+    }
 
-        VmaAllocationCreateInfo indexAllocInfo = {};
-        indexAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-        indexAllocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+    mesh.indices = indices.data();
+    mesh.indexCount = static_cast<uint32_t>(indices.size());
 
-        if (!m_transferManager->CreateBuffer(indexBufferInfo, indexAllocInfo,
-                                           mesh.indexBuffer, mesh.indexBufferAllocation)) {
-            std::cerr << "Failed to create index buffer for mesh " << i << std::endl;
-            return false;
-        }
+    // Skinned meshes stay full precision: the skinning pass reads them as
+    // SkinnedVertex and writes posed Vertex data
+    if (skinned) {
+        mesh.vertexFormat = VertexFormat::Skinned;
+        mesh.vertices = skinnedVertices.data();
+        mesh.vertexCount = static_cast<uint32_t>(skinnedVertices.size());
 
-        if (!m_transferManager->UploadBufferData(mesh.indexBuffer, mesh.indexBufferAllocation,
-                                               mesh.indices.data(), sizeof(uint32_t) * mesh.indices.size())) {
-            std::cerr << "Failed to upload index data for mesh " << i << std::endl;
-            return false;
+        // Targets that move no vertex cost nothing at runtime
+        if (morphDeltas.empty()) {
+            mesh.morphTargetCount = 0;
+            std::vector<uint32_t>().swap(morphOffsets);
+        } else {
+            morphOffsets.push_back(static_cast<uint32_t>(morphDeltas.size()));
+            mesh.morphDeltas = morphDeltas.data();
+            mesh.morphDeltaCount = static_cast<uint32_t>(morphDeltas.size());
+            mesh.morphOffsets = morphOffsets.data();
         }
-
-        // Set primitive topology
-        mesh.topology = GetVkPrimitiveTopology(primitive.mode);
+        return;
     }
 
-    return true;
+    mesh.vertices = vertices.data();
+    mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+
+    // Meshes that fit the packed format upload less than half the bytes
+    PositionQuantization quantization;
+    auto& packedVertices = geometry.packedVertices[meshIndex];
+    if (m_assetConfig.packVertices && PackVertices(vertices.data(), vertices.size(),
+                                                   m_assetConfig.packedPositionTolerance, packedVertices,
+                                                   quantization)) {
+        mesh.vertexFormat = VertexFormat::Packed;
+        mesh.positionOffset = quantization.offset;
+        mesh.positionScale = quantization.scale;
+        mesh.vertices = packedVertices.data();
+        std::vector<Vertex>().swap(vertices);
+    }
 }
 
-bool GltfLoader::LoadNodes(const tinygltf::Model& gltfModel, Model& model) {
+void GltfLoader::LoadNodes(const tinygltf::Model& gltfModel, CookedModel& cooked,
+                           std::vector<int32_t>& nodeIndices) {
+    nodeIndices.assign(gltfModel.nodes.size(), -1);
     if (gltfModel.scenes.empty()) {
-        return true; // No scenes to load
+        return; // No scenes to load
     }
 
     const auto& scene = gltfModel.scenes[0]; // Load first scene
-    model.rootNode = std::make_unique<Node>();
-    model.rootNode->name = "Root";
+    CookedNode root;
+    root.name = "Root";
+    cooked.nodes.push_back(root);
 
     // Load scene nodes
     for (size_t i = 0; i < scene.nodes.size(); i++) {
         int nodeIndex = scene.nodes[i];
         if (nodeIndex >= 0 && nodeIndex < static_cast<int>(gltfModel.nodes.size())) {
-            auto childNode = LoadNode(gltfModel, gltfModel.nodes[nodeIndex]);
-            if (childNode) {
-                model.rootNode->children.push_back(std::move(childNode));
-            }
+            LoadNode(gltfModel, nodeIndex, 0, cooked.nodes, nodeIndices);
         }
     }
-
-    return true;
 }
 
-std::unique_ptr<Node> GltfLoader::LoadNode(const tinygltf::Model& gltfModel, const tinygltf::Node& gltfNode) {
-    auto node = std::make_unique<Node>();
-    node->name = gltfNode.name;
-    node->transform = GetNodeTransform(gltfNode);
+void GltfLoader::LoadNode(const tinygltf::Model& gltfModel, int nodeIndex, int32_t parent,
+                          std::vector<CookedNode>& nodes, std::vector<int32_t>& nodeIndices) {
+    // A node reached twice would make the hierarchy shared or cyclic
+    if (nodeIndices[nodeIndex] >= 0) {
+        return;
+    }
+
+    const auto& gltfNode = gltfModel.nodes[nodeIndex];
+    int32_t index = static_cast<int32_t>(nodes.size());
+    nodeIndices[nodeIndex] = index;
+    CookedNode node;
+    node.parent = parent;
+    node.name = gltfNode.name;
+    node.transform = GetNodeTransform(gltfNode);
+    node.restPose = GetNodePose(gltfNode);
+    if (gltfNode.skin >= 0 && gltfNode.skin < static_cast<int>(gltfModel.skins.size())) {
+        node.skin = gltfNode.skin;
+    }
 
     // Load mesh indices
     if (gltfNode.mesh >= 0) {
-        node->meshIndices.push_back(static_cast<uint32_t>(gltfNode.mesh));
+        node.meshIndices.push_back(static_cast<uint32_t>(gltfNode.mesh));
     }
 
+    // Rest morph weights come from the node, else from its mesh, else zero
+    if (gltfNode.mesh >= 0 && gltfNode.mesh < static_cast<int>(gltfModel.meshes.size())) {
+        const auto& gltfMesh = gltfModel.meshes[gltfNode.mesh];
+        size_t targetCount = GetMorphTargetCount(gltfMesh);
+        const std::vector<double>* weights = gltfNode.weights.size() == targetCount ? &gltfNode.weights
+                                           : gltfMesh.weights.size() == targetCount ? &gltfMesh.weights
+                                                                                    : nullptr;
+        node.morphWeights.assign(targetCount, 0.0f);
+        for (size_t t = 0; weights && t < targetCount; t++) {
+            node.morphWeights[t] = static_cast<float>((*weights)[t]);
+        }
+    }
+    nodes.push_back(std::move(node));
+
     // Load children
     for (size_t i = 0; i < gltfNode.children.size(); i++) {
         int childIndex = gltfNode.children[i];
         if (childIndex >= 0 && childIndex < static_cast<int>(gltfModel.nodes.size())) {
-            auto childNode = LoadNode(gltfModel, gltfModel.nodes[childIndex]);
-            if (childNode) {
-                node->children.push_back(std::move(childNode));
+            LoadNode(gltfModel, childIndex, index, nodes, nodeIndices);
+        }
+    }
+}
+
+void GltfLoader::LoadSkins(const tinygltf::Model& gltfModel, const GltfBuffers& buffers,
+                           const std::vector<int32_t>& nodeIndices, CookedModel& cooked) {
+    // Skins keep their glTF indices; one that cannot be resolved stays empty
+    // and its meshes are not drawn
+    cooked.skins.resize(gltfModel.skins.size());
+    for (size_t i = 0; i < gltfModel.skins.size(); i++) {
+        const auto& gltfSkin = gltfModel.skins[i];
+        if (gltfSkin.joints.size() > std::numeric_limits<uint16_t>::max()) {
+            std::cerr << "Skin " << i << " has more joints than SkinnedVertex can address" << std::endl;
+            continue;
+        }
+
+        // Without inverse bind matrices every joint binds at identity
+        std::vector<glm::mat4> inverseBindMatrices;
+        if (gltfSkin.inverseBindMatrices >= 0) {
+            if (!ReadMatrices(gltfModel, buffers.spans, gltfSkin.inverseBindMatrices, inverseBindMatrices) ||
+                inverseBindMatrices.size() < gltfSkin.joints.size()) {
+                std::cerr << "Unreadable inverse bind matrices in skin " << i << std::endl;
+                continue;
+            }
+        }
+        inverseBindMatrices.resize(gltfSkin.joints.size(), glm::mat4(1.0f));
+
+        Skin skin;
+        for (int joint : gltfSkin.joints) {
+            if (joint < 0 || joint >= static_cast<int>(nodeIndices.size()) || nodeIndices[joint] < 0) {
+                std::cerr << "Skin " << i << " has a joint outside the loaded scene" << std::endl;
+                skin.joints.clear();
+                break;
             }
+            skin.joints.push_back(static_cast<uint32_t>(nodeIndices[joint]));
+        }
+        if (!skin.joints.empty()) {
+            skin.inverseBindMatrices = std::move(inverseBindMatrices);
+            cooked.skins[i] = std::move(skin);
         }
     }
 
-    return node;
+    // Morphed meshes without a skin get one rigidly bound to their own node,
+    // so the skinning pass places them like any other skinned mesh
+    for (size_t n = 0; n < cooked.nodes.size(); n++) {
+        CookedNode& node = cooked.nodes[n];
+        if (node.skin < 0 && !node.morphWeights.empty()) {
+            Skin skin;
+            skin.joints.push_back(static_cast<uint32_t>(n));
+            skin.inverseBindMatrices.push_back(glm::mat4(1.0f));
+            node.skin = static_cast<int32_t>(cooked.skins.size());
+            cooked.skins.push_back(std::move(skin));
+        }
+    }
 }
 
-bool GltfLoader::CreateTextureFromImage(const tinygltf::Image& image, Material& material) {
-    // For now, we'll create a simple 1x1 white texture as a placeholder
-    // In a full implementation, you would decode the image data and create proper textures
-    
+void GltfLoader::LoadAnimations(const tinygltf::Model& gltfModel, const GltfBuffers& buffers,
+                                const std::vector<int32_t>& nodeIndices, CookedModel& cooked) {
+    struct Channel {
+        uint32_t node = 0;
+        AnimationPath path = AnimationPath::Translation;
+        uint32_t morphWeight = 0; // Weights channels animate one target each
+        const tinygltf::AnimationSampler* sampler = nullptr;
+        std::vector<float> times;
+        std::vector<glm::vec4> values;
+    };
+
+    // Morph weights of all nodes are numbered together, in node order
+    std::vector<uint32_t> firstMorphWeights(cooked.nodes.size(), 0);
+    uint32_t morphWeightCount = 0;
+    for (size_t n = 0; n < cooked.nodes.size(); n++) {
+        firstMorphWeights[n] = morphWeightCount;
+        morphWeightCount += static_cast<uint32_t>(cooked.nodes[n].morphWeights.size());
+    }
+
+    size_t keyBytes = 0;
+    size_t sampleBytes = 0;
+    for (size_t a = 0; a < gltfModel.animations.size(); a++) {
+        const auto& gltfAnimation = gltfModel.animations[a];
+
+        // Channels targeting nodes outside the scene are skipped
+        std::vector<Channel> channels;
+        float duration = 0.0f;
+        for (const auto& gltfChannel : gltfAnimation.channels) {
+            Channel channel;
+            if (gltfChannel.target_path == "translation") {
+                channel.path = AnimationPath::Translation;
+            } else if (gltfChannel.target_path == "rotation") {
+                channel.path = AnimationPath::Rotation;
+            } else if (gltfChannel.target_path == "scale") {
+                channel.path = AnimationPath::Scale;
+            } else if (gltfChannel.target_path == "weights") {
+                channel.path = AnimationPath::Weights;
+            } else {
+                continue;
+            }
+            int target = gltfChannel.target_node;
+            if (target < 0 || target >= static_cast<int>(nodeIndices.size()) || nodeIndices[target] < 0 ||
+                gltfChannel.sampler < 0 || gltfChannel.sampler >= static_cast<int>(gltfAnimation.samplers.size())) {
+                continue;
+            }
+            channel.node = static_cast<uint32_t>(nodeIndices[target]);
+            channel.sampler = &gltfAnimation.samplers[gltfChannel.sampler];
+
+            std::vector<glm::vec4> times;
+            if (!ReadAccessor(gltfModel, buffers.spans, channel.sampler->input, times) ||
+                !ReadAccessor(gltfModel, buffers.spans, channel.sampler->output, channel.values) || times.empty()) {
+                std::cerr << "Unreadable sampler in animation " << a << std::endl;
+                continue;
+            }
+            channel.times.reserve(times.size());
+            for (const auto& time : times) {
+                channel.times.push_back(time.x);
+            }
+            duration = std::max(duration, channel.times.back());
+
+            if (channel.path != AnimationPath::Weights) {
+                keyBytes += (times.size() + channel.values.size() * (channel.path == AnimationPath::Rotation ? 4 : 3)) *
+                            sizeof(float);
+                channels.push_back(std::move(channel));
+                continue;
+            }
+
+            // Weight outputs interleave every target per key; each target
+            // becomes its own channel
+            size_t targetCount = cooked.nodes[channel.node].morphWeights.size();
+            if (targetCount == 0 || channel.values.size() % targetCount != 0) {
+                std::cerr << "Morph weights in animation " << a << " do not match their node" << std::endl;
+                continue;
+            }
+            keyBytes += (times.size() + channel.values.size()) * sizeof(float);
+            size_t elementCount = channel.values.size() / targetCount;
+            for (size_t t = 0; t < targetCount; t++) {
+                Channel target = channel;
+                target.morphWeight = firstMorphWeights[channel.node] + static_cast<uint32_t>(t);
+                target.values.resize(elementCount);
+                for (size_t e = 0; e < elementCount; e++) {
+                    target.values[e] = channel.values[e * targetCount + t];
+                }
+                channels.push_back(std::move(target));
+            }
+        }
+
+        if (channels.empty()) {
+            continue;
+        }
+        if (!(duration <= kMaxAnimationDuration)) {
+            std::cerr << "Skipping animation " << a << ": duration " << duration << " s" << std::endl;
+            continue;
+        }
+
+        // Every track is resampled onto the same frames, spaced so the last
+        // one lands exactly on the end of the clip
+        AnimationClip clip;
+        clip.name = gltfAnimation.name.empty() ? "animation " + std::to_string(a) : gltfAnimation.name;
+        clip.duration = duration;
+        clip.frameCount = static_cast<uint32_t>(std::ceil(duration * kAnimationSampleRate)) + 1;
+        clip.sampleRate = clip.frameCount > 1 ? static_cast<float>(clip.frameCount - 1) / duration
+                                              : kAnimationSampleRate;
+
+        std::vector<glm::vec4> samples(clip.frameCount);
+        for (const auto& channel : channels) {
+            for (uint32_t frame = 0; frame < clip.frameCount; frame++) {
+                float time = static_cast<float>(frame) / clip.sampleRate;
+                samples[frame] = EvaluateSampler(channel.times, channel.values, channel.sampler->interpolation,
+                                                 channel.path == AnimationPath::Rotation, time);
+            }
+            AppendAnimationTrack(clip, channel.node, channel.path, samples, channel.morphWeight);
+        }
+        sampleBytes += clip.samples.size() * sizeof(uint16_t) + clip.tracks.size() * sizeof(AnimationTrack);
+        cooked.animations.push_back(std::move(clip));
+    }
+
+    if (!cooked.animations.empty()) {
+        std::cout << "Cooked " << cooked.animations.size() << " animations, " << keyBytes / 1024 << " KB of keys -> "
+                  << sampleBytes / 1024 << " KB of samples" << std::endl;
+    }
+}
+
+void GltfLoader::BuildNodes(const CookedModel& cooked, Model& model) {
+    // Preorder means a parent is always built before its children
+    const auto& nodes = cooked.nodes;
+    std::vector<Node*> built(nodes.size(), nullptr);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        auto node = std::make_unique<Node>();
+        node->name = nodes[i].name;
+        node->transform = nodes[i].transform;
+        node->meshIndices = nodes[i].meshIndices;
+        node->skin = nodes[i].skin;
+        built[i] = node.get();
+
+        int32_t parent = nodes[i].parent;
+        if (parent >= 0 && static_cast<size_t>(parent) < i) {
+            built[parent]->children.push_back(std::move(node));
+        } else if (!model.rootNode) {
+            model.rootNode = std::move(node);
+        }
+    }
+
+    // Animations pose the flattened hierarchy rather than the tree
+    model.skeleton.parents.resize(nodes.size());
+    model.skeleton.restPoses.resize(nodes.size());
+    model.skeleton.firstMorphWeights.resize(nodes.size() + 1);
+    model.skeleton.restMorphWeights.clear();
+    for (size_t i = 0; i < nodes.size(); i++) {
+        int32_t parent = nodes[i].parent;
+        model.skeleton.parents[i] = parent >= 0 && static_cast<size_t>(parent) < i ? parent : -1;
+        model.skeleton.restPoses[i] = nodes[i].restPose;
+        model.skeleton.firstMorphWeights[i] = static_cast<uint32_t>(model.skeleton.restMorphWeights.size());
+        model.skeleton.restMorphWeights.insert(model.skeleton.restMorphWeights.end(),
+                                               nodes[i].morphWeights.begin(), nodes[i].morphWeights.end());
+    }
+    model.skeleton.firstMorphWeights[nodes.size()] = static_cast<uint32_t>(model.skeleton.restMorphWeights.size());
+    model.skins = cooked.skins;
+    model.animations = cooked.animations;
+
+    // Skinned meshes draw once per node that places them with a resolved skin
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const auto& node = nodes[i];
+        if (node.skin < 0 || static_cast<size_t>(node.skin) >= model.skins.size() ||
+            model.skins[node.skin].joints.empty()) {
+            continue;
+        }
+        for (uint32_t meshIndex : node.meshIndices) {
+            if (meshIndex < model.meshes.size() && model.meshes[meshIndex].vertexFormat == VertexFormat::Skinned) {
+                model.skinBindings.push_back(SkinBinding{ meshIndex, static_cast<uint32_t>(node.skin),
+                                                          static_cast<uint32_t>(i) });
+            }
+        }
+    }
+}
+
+bool GltfLoader::LoadDependencies(const tinygltf::Model& gltfModel, const std::string& filepath,
+                                  CookedModel& cooked) {
+    // External buffers and images; data URIs and GLB chunks are part of the source
+    std::filesystem::path baseDir = std::filesystem::path(filepath).parent_path();
+    auto addDependency = [&](const std::string& uri) -> bool {
+        if (uri.empty() || uri.rfind("data:", 0) == 0) {
+            return true;
+        }
+        CookedDependency dependency;
+        dependency.path = (baseDir / uri).string();
+        if (!MeshCache::HashFile(dependency.path, dependency.hash)) {
+            std::cerr << "Not caching " << filepath << ": cannot read " << dependency.path << std::endl;
+            return false;
+        }
+        cooked.dependencies.push_back(dependency);
+        return true;
+    };
+
+    for (const auto& buffer : gltfModel.buffers) {
+        if (!addDependency(buffer.uri)) {
+            return false;
+        }
+    }
+    for (const auto& image : gltfModel.images) {
+        if (!addDependency(image.uri)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GltfLoader::CreateTexture(const DecodedImage& image, const CookedTexture& source, Texture& texture,
+                               TransferBatch& batch) {
+    VkFormat format = source.format;
+
+    // Images that failed to decode fall back to a 1x1 white placeholder.
+    // Static because the batch reads the data at commit time.
+    static const uint32_t whitePixel = 0xFFFFFFFF;
+    bool decoded = !image.pixels.empty();
+
+    // KTX2 payloads keep their own format, switched to the slot's color space.
+    // Formats the device cannot sample also get the placeholder.
+    bool compressed = decoded && image.format != VK_FORMAT_UNDEFINED;
+    if (compressed) {
+        VkFormat payloadFormat = GetColorSpaceVariant(image.format, format == VK_FORMAT_R8G8B8A8_SRGB);
+        if (SupportsSampledFormat(payloadFormat)) {
+            format = payloadFormat;
+        } else {
+            std::cerr << "KTX2 format " << image.format << " is not supported by the device" << std::endl;
+            decoded = false;
+            compressed = false;
+        }
+    }
+
+    uint32_t width = decoded ? image.width : 1;
+    uint32_t height = decoded ? image.height : 1;
+    const void* pixels = decoded ? static_cast<const void*>(image.pixels.data()) : &whitePixel;
+    size_t pixelsSize = compressed ? image.pixels.size() : static_cast<size_t>(width) * height * 4;
+    const std::vector<VkDeviceSize> noLevelOffsets;
+    const std::vector<VkDeviceSize>& levelOffsets = compressed ? image.levelOffsets : noLevelOffsets;
+    uint32_t providedLevels = compressed ? image.mipLevels : 1;
+
+    // Levels the source does not carry are blitted on the GPU, which
+    // block-compressed formats do not support
+    uint32_t mipLevels = providedLevels;
+    bool generateMips = providedLevels == 1 && m_transferManager->SupportsMipGeneration(format);
+    if (generateMips) {
+        mipLevels = TransferManager::GetMipLevelCount(width, height);
+    }
+
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = 1;
-    imageInfo.extent.height = 1;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    imageInfo.format = format;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (generateMips && mipLevels > 1) {
+        imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
 
-    if (!m_transferManager->CreateImage(imageInfo, allocInfo, 
-                                      material.baseColorTexture, material.baseColorTextureAllocation)) {
+    if (!m_transferManager->CreateImage(imageInfo, allocInfo, texture.image, texture.allocation)) {
         return false;
     }
+    texture.format = format;
+    texture.width = width;
+    texture.height = height;
+    texture.mipLevels = mipLevels;
 
-    // Create white pixel data
-    uint32_t whitePixel = 0xFFFFFFFF;
-    if (!m_transferManager->UploadImageData(material.baseColorTexture, imageInfo,
-                                          &whitePixel, sizeof(whitePixel))) {
-        return false;
-    }
+    batch.AddImageCopy(texture.image, imageInfo, pixels, pixelsSize, levelOffsets, generateMips && mipLevels > 1);
 
     // Create image view
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = material.baseColorTexture;
+    viewInfo.image = texture.image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+    viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
-    if (vkCreateImageView(m_device, &viewInfo, nullptr, &material.baseColorTextureView) != VK_SUCCESS) {
+    if (vkCreateImageView(m_device, &viewInfo, nullptr, &texture.view) != VK_SUCCESS) {
         return false;
     }
 
-    // Create sampler
+    // Create sampler from the glTF sampler state; unset filters are linear
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.magFilter = GetVkFilter(source.magFilter);
+    samplerInfo.minFilter = GetVkFilter(source.minFilter);
+    samplerInfo.addressModeU = GetVkAddressMode(source.wrapS);
+    samplerInfo.addressModeV = GetVkAddressMode(source.wrapT);
     samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-    samplerInfo.maxAnisotropy = 1.0f;
+    samplerInfo.anisotropyEnable = m_maxSamplerAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+    samplerInfo.maxAnisotropy = m_maxSamplerAnisotropy;
     samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
     samplerInfo.unnormalizedCoordinates = VK_FALSE;
     samplerInfo.compareEnable = VK_FALSE;
@@ -703,119 +2399,237 @@ bool GltfLoader::CreateTextureFromImage(const tinygltf::Image& image, Material&
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
-    if (vkCreateSampler(m_device, &samplerInfo, nullptr, &material.baseColorSampler) != VK_SUCCESS) {
+    if (vkCreateSampler(m_device, &samplerInfo, nullptr, &texture.sampler) != VK_SUCCESS) {
         return false;
     }
 
     return true;
 }
 
+bool GltfLoader::SupportsSampledFormat(VkFormat format) const {
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(m_physicalDevice, format, &properties);
+    return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
 void GltfLoader::ProcessVertices(const tinygltf::Model& gltfModel, 
+                                const GltfBuffers& buffers,
                                 const tinygltf::Primitive& primitive,
                                 std::vector<Vertex>& vertices) {
     vertices.clear();
 
-    // Get position data
-    const auto& positionAccessor = gltfModel.accessors[primitive.attributes.at("POSITION")];
-    const auto& positionBufferView = gltfModel.bufferViews[positionAccessor.bufferView];
-    const auto& positionBuffer = gltfModel.buffers[positionBufferView.buffer];
-    
-    const float* positions = reinterpret_cast<const float*>(&positionBuffer.data[positionBufferView.byteOffset + positionAccessor.byteOffset]);
-    
-    // Get normal data (if available)
-    const float* normals = nullptr;
-    if (primitive.attributes.find("NORMAL") != primitive.attributes.end()) {
-        const auto& normalAccessor = gltfModel.accessors[primitive.attributes.at("NORMAL")];
-        const auto& normalBufferView = gltfModel.bufferViews[normalAccessor.bufferView];
-        const auto& normalBuffer = gltfModel.buffers[normalBufferView.buffer];
-        normals = reinterpret_cast<const float*>(&normalBuffer.data[normalBufferView.byteOffset + normalAccessor.byteOffset]);
-    }
-
-    // Get texture coordinate data (if available)
-    const float* texCoords = nullptr;
-    if (primitive.attributes.find("TEXCOORD_0") != primitive.attributes.end()) {
-        const auto& texCoordAccessor = gltfModel.accessors[primitive.attributes.at("TEXCOORD_0")];
-        const auto& texCoordBufferView = gltfModel.bufferViews[texCoordAccessor.bufferView];
-        const auto& texCoordBuffer = gltfModel.buffers[texCoordBufferView.buffer];
-        texCoords = reinterpret_cast<const float*>(&texCoordBuffer.data[texCoordBufferView.byteOffset + texCoordAccessor.byteOffset]);
-    }
-
-    // Get color data (if available)
-    const float* colors = nullptr;
-    const tinygltf::Accessor* colorAccessor = nullptr;
-    if (primitive.attributes.find("COLOR_0") != primitive.attributes.end()) {
-        colorAccessor = &gltfModel.accessors[primitive.attributes.at("COLOR_0")];
-        const auto& colorBufferView = gltfModel.bufferViews[colorAccessor->bufferView];
-        const auto& colorBuffer = gltfModel.buffers[colorBufferView.buffer];
-        colors = reinterpret_cast<const float*>(&colorBuffer.data[colorBufferView.byteOffset + colorAccessor->byteOffset]);
-    }
-
-    // Create vertices
-    vertices.resize(positionAccessor.count);
-    for (size_t i = 0; i < positionAccessor.count; i++) {
-        Vertex& vertex = vertices[i];
-        
-        // Position (required)
-        vertex.position = glm::vec3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
-        
-        // Normal (optional)
-        if (normals) {
-            vertex.normal = glm::vec3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]);
-        } else {
-            vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f); // Default up normal
-        }
-        
-        // Texture coordinates (optional)
-        if (texCoords) {
-            vertex.texCoord = glm::vec2(texCoords[i * 2], texCoords[i * 2 + 1]);
-        } else {
-            vertex.texCoord = glm::vec2(0.0f, 0.0f); // Default UV
-        }
-        
-        // Color (optional)
-        if (colors && colorAccessor) {
-            if (colorAccessor->type == TINYGLTF_TYPE_VEC3) {
-                vertex.color = glm::vec4(colors[i * 3], colors[i * 3 + 1], colors[i * 3 + 2], 1.0f);
-            } else if (colorAccessor->type == TINYGLTF_TYPE_VEC4) {
-                vertex.color = glm::vec4(colors[i * 4], colors[i * 4 + 1], colors[i * 4 + 2], colors[i * 4 + 3]);
+    // Position (required)
+    AttributeStream positions;
+    if (!GetAttributeStream(gltfModel, buffers.spans, primitive, "POSITION", positions) || positions.count == 0) {
+        return;
+    }
+
+    static const float kPositionFill[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    vertices.resize(positions.count);
+    if (!DecodeAttribute(positions, &vertices[0].position.x, sizeof(Vertex), 3, kPositionFill)) {
+        std::cerr << "Unreadable POSITION accessor" << std::endl;
+        vertices.clear();
+        return;
+    }
+
+    // One bulk pass per attribute straight into the interleaved layout, so no
+    // per-vertex branching. Missing or unreadable attributes get defaults.
+    auto decodeOptional = [&](const char* name, float* dst, uint32_t components, const float defaults[4]) {
+        AttributeStream stream;
+        if (GetAttributeStream(gltfModel, buffers.spans, primitive, name, stream)) {
+            if (stream.count >= vertices.size()) {
+                stream.count = vertices.size();
+                if (DecodeAttribute(stream, dst, sizeof(Vertex), components, defaults)) {
+                    return;
+                }
             }
-        } else {
-            vertex.color = glm::vec4(1.0f); // Default white
+            std::cerr << "Unreadable " << name << " accessor, using defaults" << std::endl;
         }
-    }
+        FillAttribute(dst, sizeof(Vertex), vertices.size(), components, defaults);
+    };
+
+    static const float kDefaultNormal[4] = {0.0f, 0.0f, 1.0f, 0.0f};
+    static const float kDefaultTexCoord[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    static const float kDefaultColor[4] = {1.0f, 1.0f, 1.0f, 1.0f}; // Also the alpha of VEC3 colors
+    decodeOptional("NORMAL", &vertices[0].normal.x, 3, kDefaultNormal);
+    decodeOptional("TEXCOORD_0", &vertices[0].texCoord.x, 2, kDefaultTexCoord);
+    decodeOptional("COLOR_0", &vertices[0].color.x, 4, kDefaultColor);
 }
 
 void GltfLoader::ProcessIndices(const tinygltf::Model& gltfModel,
+                               const GltfBuffers& buffers,
                                const tinygltf::Primitive& primitive,
                                std::vector<uint32_t>& indices) {
     indices.clear();
 
-    if (primitive.indices < 0) {
+    if (primitive.indices < 0 || primitive.indices >= static_cast<int>(gltfModel.accessors.size())) {
         return; // No indices
     }
 
     const auto& indexAccessor = gltfModel.accessors[primitive.indices];
+    if (indexAccessor.bufferView < 0 || indexAccessor.bufferView >= static_cast<int>(gltfModel.bufferViews.size())) {
+        return;
+    }
     const auto& indexBufferView = gltfModel.bufferViews[indexAccessor.bufferView];
-    const auto& indexBuffer = gltfModel.buffers[indexBufferView.buffer];
+    if (indexBufferView.buffer < 0 || indexBufferView.buffer >= static_cast<int>(buffers.spans.size())) {
+        return;
+    }
+
+    // Indices are tightly packed, and must lie within the buffer
+    const BufferSpan& indexBuffer = buffers.spans[indexBufferView.buffer];
+    size_t indexSize = GetComponentSize(indexAccessor.componentType);
+    size_t offset = indexBufferView.byteOffset + indexAccessor.byteOffset;
+    if (indexSize == 0 || offset > indexBuffer.size || indexAccessor.count > (indexBuffer.size - offset) / indexSize) {
+        std::cerr << "Unreadable index accessor" << std::endl;
+        return;
+    }
+    const unsigned char* src = indexBuffer.data + offset;
 
     indices.resize(indexAccessor.count);
 
     if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
-        const uint16_t* src = reinterpret_cast<const uint16_t*>(&indexBuffer.data[indexBufferView.byteOffset + indexAccessor.byteOffset]);
         for (size_t i = 0; i < indexAccessor.count; i++) {
-            indices[i] = static_cast<uint32_t>(src[i]);
+            uint16_t index;
+            memcpy(&index, src + i * sizeof(index), sizeof(index));
+            indices[i] = static_cast<uint32_t>(index);
         }
     } else if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT) {
-        const uint32_t* src = reinterpret_cast<const uint32_t*>(&indexBuffer.data[indexBufferView.byteOffset + indexAccessor.byteOffset]);
         memcpy(indices.data(), src, indexAccessor.count * sizeof(uint32_t));
     } else if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-        const uint8_t* src = reinterpret_cast<const uint8_t*>(&indexBuffer.data[indexBufferView.byteOffset + indexAccessor.byteOffset]);
         for (size_t i = 0; i < indexAccessor.count; i++) {
             indices[i] = static_cast<uint32_t>(src[i]);
         }
+    } else {
+        indices.clear();
+    }
+}
+
+uint32_t GltfLoader::ProcessSkinWeights(const tinygltf::Model& gltfModel,
+                                        const GltfBuffers& buffers,
+                                        const tinygltf::Primitive& primitive,
+                                        const std::vector<Vertex>& vertices,
+                                        std::vector<SkinnedVertex>& skinnedVertices) {
+    constexpr uint32_t kWeightOne = std::numeric_limits<uint16_t>::max();
+    skinnedVertices.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        SkinnedVertex& skinnedVertex = skinnedVertices[i];
+        skinnedVertex = SkinnedVertex{};
+        skinnedVertex.vertex = vertices[i];
+        skinnedVertex.weights[0] = static_cast<uint16_t>(kWeightOne);
+    }
+
+    static const float kFill[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    AttributeStream jointStream;
+    AttributeStream weightStream;
+    if (!GetAttributeStream(gltfModel, buffers.spans, primitive, "JOINTS_0", jointStream) ||
+        !GetAttributeStream(gltfModel, buffers.spans, primitive, "WEIGHTS_0", weightStream)) {
+        return 1;
+    }
+    std::vector<glm::vec4> joints(vertices.size());
+    std::vector<glm::vec4> weights(vertices.size());
+    jointStream.count = std::min(jointStream.count, vertices.size());
+    weightStream.count = std::min(weightStream.count, vertices.size());
+    if (jointStream.count < vertices.size() || weightStream.count < vertices.size() ||
+        !DecodeAttribute(jointStream, &joints[0].x, sizeof(glm::vec4), 4, kFill) ||
+        !DecodeAttribute(weightStream, &weights[0].x, sizeof(glm::vec4), 4, kFill)) {
+        std::cerr << "Unreadable JOINTS_0 or WEIGHTS_0 accessor, binding to joint 0" << std::endl;
+        return 1;
+    }
+
+    // Weights are renormalized and rounded so they sum to exactly one;
+    // unweighted influences point at joint 0 so the shader never reads past
+    // the skin's palette
+    uint32_t jointCount = 1;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        glm::vec4 weight = glm::max(weights[i], glm::vec4(0.0f));
+        for (int c = 0; c < 4; c++) {
+            float joint = joints[i][c];
+            if (!(joint >= 0.0f && joint <= static_cast<float>(kWeightOne))) {
+                weight[c] = 0.0f;
+            }
+        }
+        float sum = weight.x + weight.y + weight.z + weight.w;
+        if (!(sum > 0.0f)) {
+            continue;
+        }
+        weight /= sum;
+
+        SkinnedVertex& skinnedVertex = skinnedVertices[i];
+        int32_t total = 0;
+        int largest = 0;
+        for (int c = 0; c < 4; c++) {
+            uint16_t quantized = static_cast<uint16_t>(std::lround(weight[c] * static_cast<float>(kWeightOne)));
+            skinnedVertex.weights[c] = quantized;
+            skinnedVertex.joints[c] = quantized > 0 ? static_cast<uint16_t>(joints[i][c]) : 0;
+            if (quantized > 0) {
+                jointCount = std::max(jointCount, static_cast<uint32_t>(skinnedVertex.joints[c]) + 1);
+            }
+            total += quantized;
+            largest = weight[c] > weight[largest] ? c : largest;
+        }
+        skinnedVertex.weights[largest] = static_cast<uint16_t>(skinnedVertex.weights[largest] +
+                                                               static_cast<int32_t>(kWeightOne) - total);
+    }
+    return jointCount;
+}
+
+uint32_t GltfLoader::ProcessMorphTargets(const tinygltf::Model& gltfModel,
+                                         const GltfBuffers& buffers,
+                                         const tinygltf::Primitive& primitive,
+                                         size_t vertexCount,
+                                         std::vector<MorphDelta>& deltas,
+                                         std::vector<uint32_t>& offsets) {
+    deltas.clear();
+    offsets.assign(vertexCount + 1, 0);
+    if (primitive.targets.empty()) {
+        return 0;
+    }
+
+    // Targets missing an attribute, or with an unreadable one, leave it at rest
+    std::vector<std::vector<glm::vec4>> positions(primitive.targets.size());
+    std::vector<std::vector<glm::vec4>> normals(primitive.targets.size());
+    for (size_t t = 0; t < primitive.targets.size(); t++) {
+        const auto& target = primitive.targets[t];
+        const std::pair<const char*, std::vector<glm::vec4>*> attributes[] = {
+            { "POSITION", &positions[t] },
+            { "NORMAL", &normals[t] },
+        };
+        for (const auto& [name, values] : attributes) {
+            auto attribute = target.find(name);
+            if (attribute == target.end()) {
+                continue;
+            }
+            if (!ReadAccessor(gltfModel, buffers.spans, attribute->second, *values) ||
+                values->size() < vertexCount) {
+                std::cerr << "Unreadable " << name << " accessor in morph target " << t
+                          << ", ignoring it" << std::endl;
+                values->clear();
+            }
+        }
+    }
+
+    // Most targets move a small part of the mesh, so only vertices they
+    // actually displace are kept
+    for (size_t v = 0; v < vertexCount; v++) {
+        offsets[v] = static_cast<uint32_t>(deltas.size());
+        for (size_t t = 0; t < primitive.targets.size(); t++) {
+            MorphDelta delta;
+            delta.target = static_cast<uint32_t>(t);
+            if (!positions[t].empty()) {
+                delta.position = glm::vec3(positions[t][v]);
+            }
+            if (!normals[t].empty()) {
+                delta.normal = glm::vec3(normals[t][v]);
+            }
+            if (delta.position != glm::vec3(0.0f) || delta.normal != glm::vec3(0.0f)) {
+                deltas.push_back(delta);
+            }
+        }
     }
+    offsets[vertexCount] = static_cast<uint32_t>(deltas.size());
+    return static_cast<uint32_t>(primitive.targets.size());
 }
 
 glm::mat4 GltfLoader::GetNodeTransform(const tinygltf::Node& node) {
@@ -0,0 +1,233 @@
+#include "assets/ktx2.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace aero_boar {
+
+namespace {
+
+const unsigned char kKtx2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+// Fixed part of the file: identifier, header and index
+constexpr size_t kHeaderSize = 80;
+constexpr size_t kLevelIndexEntrySize = 24;
+
+// Level data is repacked on this alignment, which covers every block size
+constexpr VkDeviceSize kLevelAlignment = 16;
+
+template<typename T>
+T ReadValue(const unsigned char* bytes, size_t offset) {
+    T value;
+    std::memcpy(&value, bytes + offset, sizeof(T));
+    return value;
+}
+
+struct FormatPair {
+    VkFormat unorm;
+    VkFormat srgb;
+};
+
+const FormatPair kColorSpacePairs[] = {
+    {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_SRGB},
+    {VK_FORMAT_BC1_RGB_UNORM_BLOCK, VK_FORMAT_BC1_RGB_SRGB_BLOCK},
+    {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, VK_FORMAT_BC1_RGBA_SRGB_BLOCK},
+    {VK_FORMAT_BC3_UNORM_BLOCK, VK_FORMAT_BC3_SRGB_BLOCK},
+    {VK_FORMAT_BC7_UNORM_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK},
+    {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK},
+    {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK},
+    {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, VK_FORMAT_ASTC_4x4_SRGB_BLOCK},
+    {VK_FORMAT_ASTC_6x6_UNORM_BLOCK, VK_FORMAT_ASTC_6x6_SRGB_BLOCK},
+    {VK_FORMAT_ASTC_8x8_UNORM_BLOCK, VK_FORMAT_ASTC_8x8_SRGB_BLOCK},
+};
+
+// Texel block of a format: its extent and size in bytes
+struct FormatBlock {
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t bytes = 0;
+};
+
+struct FormatBlockEntry {
+    VkFormat format;
+    FormatBlock block;
+};
+
+const FormatBlockEntry kFormatBlocks[] = {
+    {VK_FORMAT_R8_UNORM, {1, 1, 1}},
+    {VK_FORMAT_R8_SRGB, {1, 1, 1}},
+    {VK_FORMAT_R8G8_UNORM, {1, 1, 2}},
+    {VK_FORMAT_R8G8_SRGB, {1, 1, 2}},
+    {VK_FORMAT_R8G8B8A8_UNORM, {1, 1, 4}},
+    {VK_FORMAT_R8G8B8A8_SRGB, {1, 1, 4}},
+    {VK_FORMAT_B8G8R8A8_UNORM, {1, 1, 4}},
+    {VK_FORMAT_B8G8R8A8_SRGB, {1, 1, 4}},
+    {VK_FORMAT_A2B10G10R10_UNORM_PACK32, {1, 1, 4}},
+    {VK_FORMAT_B10G11R11_UFLOAT_PACK32, {1, 1, 4}},
+    {VK_FORMAT_E5B9G9R9_UFLOAT_PACK32, {1, 1, 4}},
+    {VK_FORMAT_R16_SFLOAT, {1, 1, 2}},
+    {VK_FORMAT_R16G16_SFLOAT, {1, 1, 4}},
+    {VK_FORMAT_R16G16B16A16_SFLOAT, {1, 1, 8}},
+    {VK_FORMAT_R32_SFLOAT, {1, 1, 4}},
+    {VK_FORMAT_R32G32_SFLOAT, {1, 1, 8}},
+    {VK_FORMAT_R32G32B32A32_SFLOAT, {1, 1, 16}},
+    {VK_FORMAT_BC1_RGB_UNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_BC1_RGB_SRGB_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_BC2_UNORM_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC2_SRGB_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC3_UNORM_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC3_SRGB_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC4_UNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_BC4_SNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_BC5_UNORM_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC5_SNORM_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC6H_UFLOAT_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC6H_SFLOAT_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC7_UNORM_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_BC7_SRGB_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_EAC_R11_UNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_EAC_R11_SNORM_BLOCK, {4, 4, 8}},
+    {VK_FORMAT_EAC_R11G11_UNORM_BLOCK, {4, 4, 16}},
+    {VK_FORMAT_EAC_R11G11_SNORM_BLOCK, {4, 4, 16}},
+};
+
+// ASTC formats come in UNORM/SRGB pairs, in this order of block extents
+const uint32_t kAstcBlockExtents[][2] = {
+    {4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6},
+    {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12},
+};
+
+bool GetFormatBlock(VkFormat format, FormatBlock& block) {
+    if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+        const uint32_t* extent = kAstcBlockExtents[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+        block = FormatBlock{extent[0], extent[1], 16};
+        return true;
+    }
+    for (const auto& entry : kFormatBlocks) {
+        if (entry.format == format) {
+            block = entry.block;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool IsKtx2(const unsigned char* bytes, size_t size) {
+    return size >= sizeof(kKtx2Identifier) && std::memcmp(bytes, kKtx2Identifier, sizeof(kKtx2Identifier)) == 0;
+}
+
+bool ReadKtx2(const unsigned char* bytes, size_t size, Ktx2Image& image, std::string& error) {
+    image = Ktx2Image{};
+
+    if (!IsKtx2(bytes, size) || size < kHeaderSize) {
+        error = "not a KTX2 file";
+        return false;
+    }
+
+    uint32_t vkFormat = ReadValue<uint32_t>(bytes, 12);
+    uint32_t width = ReadValue<uint32_t>(bytes, 20);
+    uint32_t height = ReadValue<uint32_t>(bytes, 24);
+    uint32_t depth = ReadValue<uint32_t>(bytes, 28);
+    uint32_t layerCount = ReadValue<uint32_t>(bytes, 32);
+    uint32_t faceCount = ReadValue<uint32_t>(bytes, 36);
+    uint32_t levelCount = ReadValue<uint32_t>(bytes, 40);
+    uint32_t supercompression = ReadValue<uint32_t>(bytes, 44);
+
+    if (vkFormat == VK_FORMAT_UNDEFINED) {
+        error = "Basis Universal payload needs a transcoder";
+        return false;
+    }
+    if (supercompression != 0) {
+        error = "supercompression scheme " + std::to_string(supercompression) + " is not supported";
+        return false;
+    }
+    if (width == 0 || height == 0 || depth > 1 || layerCount > 1 || faceCount != 1) {
+        error = "only single-layer 2D textures are supported";
+        return false;
+    }
+
+    // Levels are uploaded by size, so the format's block layout must be known
+    FormatBlock block;
+    if (!GetFormatBlock(static_cast<VkFormat>(vkFormat), block)) {
+        error = "format " + std::to_string(vkFormat) + " is not supported";
+        return false;
+    }
+
+    // A level count of 0 asks the loader to generate the mip chain
+    uint32_t storedLevels = std::max(levelCount, 1u);
+    uint32_t maxLevels = 1;
+    while ((std::max(width, height) >> maxLevels) > 0) {
+        maxLevels++;
+    }
+    if (storedLevels > maxLevels) {
+        error = std::to_string(storedLevels) + " levels exceed the full mip chain of " + std::to_string(maxLevels);
+        return false;
+    }
+    if (size < kHeaderSize + storedLevels * kLevelIndexEntrySize) {
+        error = "truncated level index";
+        return false;
+    }
+
+    // Levels are stored smallest first in the file; repack them level 0 first
+    VkDeviceSize packedSize = 0;
+    for (uint32_t level = 0; level < storedLevels; level++) {
+        size_t entry = kHeaderSize + level * kLevelIndexEntrySize;
+        uint64_t byteOffset = ReadValue<uint64_t>(bytes, entry);
+        uint64_t byteLength = ReadValue<uint64_t>(bytes, entry + 8);
+        if (byteLength == 0 || byteOffset > size || byteLength > size - byteOffset) {
+            error = "level " + std::to_string(level) + " is out of bounds";
+            return false;
+        }
+
+        // Each level holds exactly the blocks covering its extent; the upload
+        // copies that many bytes from the level's offset
+        uint64_t levelWidth = std::max(width >> level, 1u);
+        uint64_t levelHeight = std::max(height >> level, 1u);
+        uint64_t expectedLength = (levelWidth + block.width - 1) / block.width *
+                                  ((levelHeight + block.height - 1) / block.height) * block.bytes;
+        if (byteLength != expectedLength) {
+            error = "level " + std::to_string(level) + " has " + std::to_string(byteLength) + " bytes, expected " +
+                    std::to_string(expectedLength);
+            return false;
+        }
+
+        packedSize = (packedSize + kLevelAlignment - 1) / kLevelAlignment * kLevelAlignment;
+        image.levelOffsets.push_back(packedSize);
+        packedSize += byteLength;
+    }
+
+    image.data.resize(static_cast<size_t>(packedSize));
+    for (uint32_t level = 0; level < storedLevels; level++) {
+        size_t entry = kHeaderSize + level * kLevelIndexEntrySize;
+        uint64_t byteOffset = ReadValue<uint64_t>(bytes, entry);
+        uint64_t byteLength = ReadValue<uint64_t>(bytes, entry + 8);
+        std::memcpy(image.data.data() + image.levelOffsets[level], bytes + byteOffset, byteLength);
+    }
+
+    image.format = static_cast<VkFormat>(vkFormat);
+    image.width = width;
+    image.height = height;
+    image.mipLevels = storedLevels;
+    return true;
+}
+
+VkFormat GetColorSpaceVariant(VkFormat format, bool srgb) {
+    for (const auto& pair : kColorSpacePairs) {
+        if (format == pair.unorm || format == pair.srgb) {
+            return srgb ? pair.srgb : pair.unorm;
+        }
+    }
+    return format;
+}
+
+} // namespace aero_boar
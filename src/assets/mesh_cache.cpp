@@ -0,0 +1,487 @@
+#include "assets/mesh_cache.hpp"
+#include "assets/vertex_packing.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+namespace aero_boar {
+
+namespace {
+
+constexpr uint32_t kCookedModelMagic = 0x4D434241; // "ABCM"
+
+// Blobs are aligned so vertex and index data can be read in place
+constexpr size_t kBlobAlignment = 16;
+
+static_assert(std::is_trivially_copyable_v<Vertex>, "Vertex is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<PackedVertex>, "PackedVertex is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<SkinnedVertex>, "SkinnedVertex is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<MorphDelta>, "MorphDelta is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<Material>, "Material is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<Submesh>, "Submesh is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<VertexCacheStats>, "VertexCacheStats is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<NodePose>, "NodePose is written to the cache as raw bytes");
+static_assert(std::is_trivially_copyable_v<AnimationTrack>, "AnimationTrack is written to the cache as raw bytes");
+
+struct CookedHeader {
+    uint32_t magic = kCookedModelMagic;
+    uint32_t version = kCookedModelVersion;
+    uint64_t sourceHash = 0;
+    uint32_t vertexSize = sizeof(Vertex);
+    uint32_t packedVertexSize = sizeof(PackedVertex);
+    uint32_t skinnedVertexSize = sizeof(SkinnedVertex);
+    uint32_t materialSize = sizeof(Material);
+    uint32_t dependencyCount = 0;
+    uint32_t imageCount = 0;
+    uint32_t textureCount = 0;
+    uint32_t materialCount = 0;
+    uint32_t meshCount = 0;
+    uint32_t nodeCount = 0;
+    uint32_t skinCount = 0;
+    uint32_t animationCount = 0;
+};
+
+class CacheWriter {
+public:
+    explicit CacheWriter(std::ofstream& stream) : m_stream(stream) {}
+
+    template<typename T>
+    void Write(const T& value) {
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteString(const std::string& value) {
+        Write(static_cast<uint32_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+
+    // Size, then the bytes at the next aligned offset
+    void WriteBlob(const void* data, uint64_t size) {
+        Write(size);
+        static const char padding[kBlobAlignment] = {};
+        WriteBytes(padding, (kBlobAlignment - m_offset % kBlobAlignment) % kBlobAlignment);
+        WriteBytes(data, static_cast<size_t>(size));
+    }
+
+private:
+    std::ofstream& m_stream;
+    uint64_t m_offset = 0;
+
+    void WriteBytes(const void* data, size_t size) {
+        m_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        m_offset += size;
+    }
+};
+
+// Bounds-checked cursor over the mapped entry; any overrun fails the read
+class CacheReader {
+public:
+    CacheReader(const unsigned char* data, size_t size) : m_data(data), m_size(size) {}
+
+    template<typename T>
+    bool Read(T& value) {
+        if (sizeof(T) > m_size - m_offset) {
+            return false;
+        }
+        std::memcpy(&value, m_data + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(std::string& value) {
+        uint32_t length = 0;
+        if (!Read(length) || length > m_size - m_offset) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+
+    bool ReadBlob(const unsigned char*& data, uint64_t& size) {
+        if (!Read(size)) {
+            return false;
+        }
+        size_t aligned = (m_offset + kBlobAlignment - 1) / kBlobAlignment * kBlobAlignment;
+        if (aligned > m_size || size > m_size - aligned) {
+            return false;
+        }
+        data = m_data + aligned;
+        m_offset = aligned + static_cast<size_t>(size);
+        return true;
+    }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+};
+
+} // namespace
+
+MeshCache::MeshCache(const std::string& directory) : m_directory(directory) {
+}
+
+uint64_t MeshCache::HashBytes(const unsigned char* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+bool MeshCache::HashFile(const std::string& filepath, uint64_t& hash) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        return false;
+    }
+    hash = HashBytes(file.GetData(), file.GetSize());
+    return true;
+}
+
+std::string MeshCache::GetEntryPath(uint64_t sourceHash) const {
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << sourceHash << ".cooked";
+    return (std::filesystem::path(m_directory) / name.str()).string();
+}
+
+bool MeshCache::Read(uint64_t sourceHash, MappedFile& file, CookedModel& model) const {
+    if (!file.Open(GetEntryPath(sourceHash))) {
+        return false;
+    }
+
+    CacheReader reader(file.GetData(), file.GetSize());
+    CookedHeader header;
+    if (!reader.Read(header) || header.magic != kCookedModelMagic || header.version != kCookedModelVersion ||
+        header.sourceHash != sourceHash || header.vertexSize != sizeof(Vertex) ||
+        header.packedVertexSize != sizeof(PackedVertex) || header.skinnedVertexSize != sizeof(SkinnedVertex) ||
+        header.materialSize != sizeof(Material)) {
+        file.Close();
+        return false;
+    }
+
+    // Every record takes at least a byte, which bounds the counts of a corrupt header
+    uint64_t recordCount = static_cast<uint64_t>(header.dependencyCount) + header.imageCount +
+                           header.textureCount + header.materialCount + header.meshCount + header.nodeCount +
+                           header.skinCount + header.animationCount;
+    if (recordCount > file.GetSize()) {
+        file.Close();
+        return false;
+    }
+
+    model = CookedModel{};
+    model.sourceHash = sourceHash;
+
+    bool valid = true;
+    model.dependencies.resize(header.dependencyCount);
+    for (auto& dependency : model.dependencies) {
+        valid = valid && reader.ReadString(dependency.path) && reader.Read(dependency.hash);
+    }
+
+    model.images.resize(header.imageCount);
+    for (auto& image : model.images) {
+        uint64_t size = 0;
+        valid = valid && reader.ReadString(image.name) && reader.ReadBlob(image.data, size);
+        image.size = static_cast<size_t>(size);
+    }
+
+    model.textures.resize(header.textureCount);
+    for (auto& texture : model.textures) {
+        valid = valid && reader.Read(texture);
+    }
+
+    model.materials.resize(header.materialCount);
+    for (auto& material : model.materials) {
+        valid = valid && reader.Read(material);
+    }
+
+    model.meshes.resize(header.meshCount);
+    for (auto& mesh : model.meshes) {
+        const unsigned char* vertices = nullptr;
+        const unsigned char* indices = nullptr;
+        const unsigned char* morphDeltas = nullptr;
+        const unsigned char* morphOffsets = nullptr;
+        uint64_t vertexBytes = 0;
+        uint64_t indexBytes = 0;
+        uint64_t morphDeltaBytes = 0;
+        uint64_t morphOffsetBytes = 0;
+        uint32_t submeshCount = 0;
+        valid = valid && reader.Read(mesh.vertexFormat) &&
+                (mesh.vertexFormat == VertexFormat::Float32 || mesh.vertexFormat == VertexFormat::Packed ||
+                 mesh.vertexFormat == VertexFormat::Skinned) &&
+                reader.Read(mesh.positionOffset) && reader.Read(mesh.positionScale) && reader.Read(mesh.jointCount) &&
+                reader.Read(mesh.morphTargetCount) && reader.Read(mesh.sourceCacheStats) && reader.Read(mesh.cacheStats) &&
+                reader.Read(submeshCount) && submeshCount <= file.GetSize();
+        for (uint32_t i = 0; valid && i < submeshCount; i++) {
+            Submesh submesh;
+            valid = reader.Read(submesh);
+            mesh.submeshes.push_back(submesh);
+        }
+        valid = valid && reader.ReadBlob(vertices, vertexBytes) && reader.ReadBlob(indices, indexBytes) &&
+                vertexBytes % GetVertexStride(mesh.vertexFormat) == 0 && indexBytes % sizeof(uint32_t) == 0 &&
+                vertexBytes / GetVertexStride(mesh.vertexFormat) <= std::numeric_limits<uint32_t>::max() &&
+                indexBytes / sizeof(uint32_t) <= std::numeric_limits<uint32_t>::max();
+        mesh.vertices = vertices;
+        mesh.vertexCount = static_cast<uint32_t>(vertexBytes / GetVertexStride(mesh.vertexFormat));
+        mesh.indices = reinterpret_cast<const uint32_t*>(indices);
+        mesh.indexCount = static_cast<uint32_t>(indexBytes / sizeof(uint32_t));
+
+        // The skinning pass reads the palette at all four joints of a vertex,
+        // weighted or not, so each must lie within the mesh's joints
+        if (valid && mesh.vertexFormat == VertexFormat::Skinned) {
+            const SkinnedVertex* skinnedVertices = reinterpret_cast<const SkinnedVertex*>(vertices);
+            for (uint32_t v = 0; valid && v < mesh.vertexCount; v++) {
+                for (uint16_t joint : skinnedVertices[v].joints) {
+                    valid = valid && joint < mesh.jointCount;
+                }
+            }
+        }
+
+        // Submeshes draw straight from the uploaded ranges, so each must stay
+        // inside the mesh's indices and every index inside its vertices
+        for (const auto& submesh : mesh.submeshes) {
+            valid = valid && submesh.vertexOffset >= 0 &&
+                    static_cast<uint64_t>(submesh.firstIndex) + submesh.indexCount <= mesh.indexCount;
+            uint64_t vertexOffset = valid ? static_cast<uint64_t>(submesh.vertexOffset) : 0;
+            for (uint32_t i = 0; valid && i < submesh.indexCount; i++) {
+                valid = vertexOffset + mesh.indices[submesh.firstIndex + i] < mesh.vertexCount;
+            }
+        }
+
+        // Delta ranges must be in order and every delta must name a target
+        // of the mesh, or the skinning pass would read out of bounds
+        valid = valid && reader.ReadBlob(morphDeltas, morphDeltaBytes) &&
+                reader.ReadBlob(morphOffsets, morphOffsetBytes);
+        if (valid && morphDeltaBytes > 0) {
+            mesh.morphDeltas = reinterpret_cast<const MorphDelta*>(morphDeltas);
+            mesh.morphDeltaCount = static_cast<uint32_t>(morphDeltaBytes / sizeof(MorphDelta));
+            mesh.morphOffsets = reinterpret_cast<const uint32_t*>(morphOffsets);
+            valid = mesh.vertexFormat == VertexFormat::Skinned &&
+                    morphOffsetBytes == (static_cast<uint64_t>(mesh.vertexCount) + 1) * sizeof(uint32_t) &&
+                    mesh.morphOffsets[0] == 0 && mesh.morphOffsets[mesh.vertexCount] == mesh.morphDeltaCount;
+            for (uint32_t v = 0; valid && v < mesh.vertexCount; v++) {
+                valid = mesh.morphOffsets[v] <= mesh.morphOffsets[v + 1];
+            }
+            for (uint32_t d = 0; valid && d < mesh.morphDeltaCount; d++) {
+                valid = mesh.morphDeltas[d].target < mesh.morphTargetCount;
+            }
+        } else {
+            valid = valid && morphOffsetBytes == 0 && mesh.morphTargetCount == 0;
+        }
+    }
+
+    uint64_t totalMorphWeights = 0;
+    // Nodes are in preorder, so a parent always comes before its children
+    model.nodes.resize(header.nodeCount);
+    for (size_t n = 0; n < model.nodes.size(); n++) {
+        auto& node = model.nodes[n];
+        uint32_t meshCount = 0;
+        uint32_t morphWeightCount = 0;
+        valid = valid && reader.Read(node.parent) && node.parent >= -1 && node.parent < static_cast<int64_t>(n) &&
+                reader.Read(node.transform) && reader.Read(node.restPose) &&
+                reader.Read(node.skin) && node.skin >= -1 && node.skin < static_cast<int32_t>(header.skinCount) &&
+                reader.Read(meshCount);
+        for (uint32_t i = 0; valid && i < meshCount; i++) {
+            uint32_t meshIndex = 0;
+            valid = reader.Read(meshIndex) && meshIndex < header.meshCount;
+            node.meshIndices.push_back(meshIndex);
+        }
+        valid = valid && reader.Read(morphWeightCount) && morphWeightCount <= file.GetSize();
+        for (uint32_t i = 0; valid && i < morphWeightCount; i++) {
+            float weight = 0.0f;
+            valid = reader.Read(weight);
+            node.morphWeights.push_back(weight);
+        }
+        valid = valid && reader.ReadString(node.name);
+        totalMorphWeights += morphWeightCount;
+    }
+
+    // Joints and animated nodes must be nodes of this model
+    model.skins.resize(header.skinCount);
+    for (auto& skin : model.skins) {
+        uint32_t jointCount = 0;
+        valid = valid && reader.Read(jointCount) && jointCount <= file.GetSize();
+        for (uint32_t i = 0; valid && i < jointCount; i++) {
+            uint32_t joint = 0;
+            glm::mat4 inverseBindMatrix;
+            valid = reader.Read(joint) && joint < header.nodeCount && reader.Read(inverseBindMatrix);
+            skin.joints.push_back(joint);
+            skin.inverseBindMatrices.push_back(inverseBindMatrix);
+        }
+    }
+
+    model.animations.resize(header.animationCount);
+    for (auto& clip : model.animations) {
+        uint32_t trackCount = 0;
+        const unsigned char* samples = nullptr;
+        uint64_t sampleBytes = 0;
+        valid = valid && reader.ReadString(clip.name) && reader.Read(clip.duration) && reader.Read(clip.sampleRate) &&
+                reader.Read(clip.frameCount) && reader.Read(trackCount) && trackCount <= file.GetSize();
+        for (uint32_t i = 0; valid && i < trackCount; i++) {
+            AnimationTrack track;
+            valid = reader.Read(track);
+            clip.tracks.push_back(track);
+        }
+        valid = valid && reader.ReadBlob(samples, sampleBytes);
+        if (valid) {
+            clip.samples.resize(static_cast<size_t>(sampleBytes / sizeof(uint16_t)));
+            std::memcpy(clip.samples.data(), samples, clip.samples.size() * sizeof(uint16_t));
+        }
+        for (const auto& track : clip.tracks) {
+            uint64_t components = track.path == AnimationPath::Rotation ? 4
+                                : track.path == AnimationPath::Weights  ? 1
+                                                                        : 3;
+            valid = valid && track.node < header.nodeCount && track.path <= AnimationPath::Weights &&
+                    (track.path != AnimationPath::Weights || track.morphWeight < totalMorphWeights) &&
+                    (track.sampleCount == 1 || track.sampleCount == clip.frameCount) &&
+                    track.firstSample + components * track.sampleCount <= clip.samples.size();
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "Discarding truncated mesh cache entry " << GetEntryPath(sourceHash) << std::endl;
+        file.Close();
+        return false;
+    }
+
+    // A .gltf is only as fresh as its buffers and images
+    for (const auto& dependency : model.dependencies) {
+        uint64_t hash = 0;
+        if (!HashFile(dependency.path, hash) || hash != dependency.hash) {
+            file.Close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MeshCache::Write(const CookedModel& model) const {
+    std::string entryPath = GetEntryPath(model.sourceHash);
+    std::string tempPath = entryPath + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+                           ".tmp";
+
+    try {
+        std::filesystem::create_directories(m_directory);
+
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            std::cerr << "Failed to create mesh cache entry " << tempPath << std::endl;
+            return false;
+        }
+
+        CookedHeader header;
+        header.sourceHash = model.sourceHash;
+        header.dependencyCount = static_cast<uint32_t>(model.dependencies.size());
+        header.imageCount = static_cast<uint32_t>(model.images.size());
+        header.textureCount = static_cast<uint32_t>(model.textures.size());
+        header.materialCount = static_cast<uint32_t>(model.materials.size());
+        header.meshCount = static_cast<uint32_t>(model.meshes.size());
+        header.nodeCount = static_cast<uint32_t>(model.nodes.size());
+        header.skinCount = static_cast<uint32_t>(model.skins.size());
+        header.animationCount = static_cast<uint32_t>(model.animations.size());
+
+        CacheWriter writer(stream);
+        writer.Write(header);
+
+        for (const auto& dependency : model.dependencies) {
+            writer.WriteString(dependency.path);
+            writer.Write(dependency.hash);
+        }
+
+        for (const auto& image : model.images) {
+            writer.WriteString(image.name);
+            writer.WriteBlob(image.data, image.size);
+        }
+
+        for (const auto& texture : model.textures) {
+            writer.Write(texture);
+        }
+
+        for (const auto& material : model.materials) {
+            writer.Write(material);
+        }
+
+        for (const auto& mesh : model.meshes) {
+            writer.Write(mesh.vertexFormat);
+            writer.Write(mesh.positionOffset);
+            writer.Write(mesh.positionScale);
+            writer.Write(mesh.jointCount);
+            writer.Write(mesh.morphTargetCount);
+            writer.Write(mesh.sourceCacheStats);
+            writer.Write(mesh.cacheStats);
+            writer.Write(static_cast<uint32_t>(mesh.submeshes.size()));
+            for (const auto& submesh : mesh.submeshes) {
+                writer.Write(submesh);
+            }
+            writer.WriteBlob(mesh.vertices, static_cast<uint64_t>(mesh.vertexCount) *
+                                                GetVertexStride(mesh.vertexFormat));
+            writer.WriteBlob(mesh.indices, static_cast<uint64_t>(mesh.indexCount) * sizeof(uint32_t));
+            writer.WriteBlob(mesh.morphDeltas, static_cast<uint64_t>(mesh.morphDeltaCount) * sizeof(MorphDelta));
+            writer.WriteBlob(mesh.morphOffsets, mesh.morphDeltaCount > 0
+                                                    ? (static_cast<uint64_t>(mesh.vertexCount) + 1) * sizeof(uint32_t)
+                                                    : 0);
+        }
+
+        for (const auto& node : model.nodes) {
+            writer.Write(node.parent);
+            writer.Write(node.transform);
+            writer.Write(node.restPose);
+            writer.Write(node.skin);
+            writer.Write(static_cast<uint32_t>(node.meshIndices.size()));
+            for (uint32_t meshIndex : node.meshIndices) {
+                writer.Write(meshIndex);
+            }
+            writer.Write(static_cast<uint32_t>(node.morphWeights.size()));
+            for (float weight : node.morphWeights) {
+                writer.Write(weight);
+            }
+            writer.WriteString(node.name);
+        }
+
+        for (const auto& skin : model.skins) {
+            writer.Write(static_cast<uint32_t>(skin.joints.size()));
+            for (size_t i = 0; i < skin.joints.size(); i++) {
+                writer.Write(skin.joints[i]);
+                writer.Write(skin.inverseBindMatrices[i]);
+            }
+        }
+
+        for (const auto& clip : model.animations) {
+            writer.WriteString(clip.name);
+            writer.Write(clip.duration);
+            writer.Write(clip.sampleRate);
+            writer.Write(clip.frameCount);
+            writer.Write(static_cast<uint32_t>(clip.tracks.size()));
+            for (const auto& track : clip.tracks) {
+                writer.Write(track);
+            }
+            writer.WriteBlob(clip.samples.data(), clip.samples.size() * sizeof(uint16_t));
+        }
+
+        stream.close();
+        if (!stream) {
+            std::cerr << "Failed to write mesh cache entry " << tempPath << std::endl;
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+
+        std::filesystem::rename(tempPath, entryPath);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to write mesh cache entry " << entryPath << ": " << e.what() << std::endl;
+        std::error_code ignored;
+        std::filesystem::remove(tempPath, ignored);
+        return false;
+    }
+}
+
+} // namespace aero_boar
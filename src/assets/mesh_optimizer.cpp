@@ -0,0 +1,295 @@
+#include "assets/mesh_optimizer.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace aero_boar {
+
+namespace {
+
+constexpr uint32_t kNoVertex = ~0u;
+
+// FIFO post-transform cache modelled with timestamps: a vertex is resident
+// while fewer than kVertexCacheSize misses happened since it was loaded
+class VertexCache {
+public:
+    explicit VertexCache(size_t vertexCount) : m_timestamps(vertexCount, 0) {}
+
+    // Misses since the vertex was loaded
+    uint32_t GetAge(uint32_t vertex) const { return m_time - m_timestamps[vertex]; }
+
+    // Returns the number of misses
+    uint32_t Access(uint32_t vertex) {
+        if (GetAge(vertex) <= kVertexCacheSize) {
+            return 0;
+        }
+        m_timestamps[vertex] = m_time++;
+        return 1;
+    }
+
+    uint32_t AccessTriangle(const uint32_t* triangle) {
+        return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+    }
+
+    // Evicts everything
+    void Reset() { m_time += kVertexCacheSize + 1; }
+
+private:
+    std::vector<uint32_t> m_timestamps;
+    uint32_t m_time = kVertexCacheSize + 1;
+};
+
+bool HasValidIndices(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    return std::all_of(indices, indices + indexCount, [vertexCount](uint32_t index) { return index < vertexCount; });
+}
+
+// Tipsify (Sander, Nehab and Barczak 2007): fans around a vertex that is
+// likely still cached, restarting at dead ends. Returns the reordered
+// indices; hardClusters receives the first triangle after each restart.
+std::vector<uint32_t> Tipsify(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                              std::vector<uint32_t>& hardClusters) {
+    size_t triangleCount = indexCount / 3;
+
+    // Triangles around each vertex, as ranges of one array
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (size_t k = 0; k < 3; k++) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+    }
+
+    // Unemitted triangles per vertex
+    std::vector<uint32_t> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        live[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> ordered;
+    ordered.reserve(triangleCount * 3);
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    VertexCache cache(vertexCount);
+
+    size_t cursor = 0;
+    uint32_t fanning = triangleCount > 0 ? indices[0] : kNoVertex;
+    hardClusters.assign(1, 0);
+    while (fanning != kNoVertex) {
+        candidates.clear();
+        for (uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++) {
+            uint32_t t = adjacency[a];
+            if (emitted[t]) {
+                continue;
+            }
+            emitted[t] = true;
+            for (size_t k = 0; k < 3; k++) {
+                uint32_t v = indices[t * 3 + k];
+                ordered.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                cache.Access(v);
+            }
+        }
+
+        // Prefer the oldest neighbour that stays cached while its own fan is emitted
+        uint32_t next = kNoVertex;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (cache.GetAge(v) + 2 * live[v] <= kVertexCacheSize) {
+                priority = cache.GetAge(v);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        if (next == kNoVertex) {
+            // Dead end: resume at a recently emitted vertex, else the next
+            // unfinished one in input order
+            while (next == kNoVertex && !deadEnds.empty()) {
+                uint32_t v = deadEnds.back();
+                deadEnds.pop_back();
+                if (live[v] > 0) {
+                    next = v;
+                }
+            }
+            while (next == kNoVertex && cursor < vertexCount) {
+                if (live[cursor] > 0) {
+                    next = static_cast<uint32_t>(cursor);
+                }
+                cursor++;
+            }
+            uint32_t emittedTriangles = static_cast<uint32_t>(ordered.size() / 3);
+            if (next != kNoVertex && emittedTriangles > hardClusters.back()) {
+                hardClusters.push_back(emittedTriangles);
+            }
+        }
+        fanning = next;
+    }
+
+    return ordered;
+}
+
+// Cuts each hard cluster wherever the miss ratio so far is within threshold
+// of the whole cluster's, so overdraw sorting gets more, smaller clusters
+std::vector<uint32_t> SplitClusters(const std::vector<uint32_t>& ordered, size_t vertexCount,
+                                    const std::vector<uint32_t>& hardClusters, float threshold) {
+    uint32_t triangleCount = static_cast<uint32_t>(ordered.size() / 3);
+    std::vector<uint32_t> clusters;
+    VertexCache cache(vertexCount);
+
+    for (size_t c = 0; c < hardClusters.size(); c++) {
+        uint32_t begin = hardClusters[c];
+        uint32_t end = c + 1 < hardClusters.size() ? hardClusters[c + 1] : triangleCount;
+
+        uint32_t clusterMisses = 0;
+        for (uint32_t t = begin; t < end; t++) {
+            clusterMisses += cache.AccessTriangle(&ordered[t * 3]);
+        }
+        float limit = threshold * float(clusterMisses) / float(end - begin);
+        cache.Reset();
+
+        clusters.push_back(begin);
+        uint32_t start = begin;
+        uint32_t misses = 0;
+        for (uint32_t t = begin; t + 1 < end; t++) {
+            misses += cache.AccessTriangle(&ordered[t * 3]);
+            if (float(misses) <= limit * float(t + 1 - start)) {
+                clusters.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                cache.Reset();
+            }
+        }
+        cache.Reset();
+    }
+
+    return clusters;
+}
+
+} // namespace
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    VertexCacheStats stats;
+    if (!HasValidIndices(indices, indexCount, vertexCount)) {
+        return stats;
+    }
+
+    VertexCache cache(vertexCount);
+    std::vector<bool> referenced(vertexCount, false);
+    stats.triangleCount = static_cast<uint32_t>(indexCount / 3);
+    for (size_t i = 0; i < size_t(stats.triangleCount) * 3; i++) {
+        stats.transformCount += cache.Access(indices[i]);
+        if (!referenced[indices[i]]) {
+            referenced[indices[i]] = true;
+            stats.vertexCount++;
+        }
+    }
+    return stats;
+}
+
+bool OptimizeTriangleOrder(uint32_t* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                           float overdrawThreshold) {
+    size_t triangleCount = indexCount / 3;
+    if (!HasValidIndices(indices, triangleCount * 3, vertexCount)) {
+        return false;
+    }
+    if (triangleCount == 0) {
+        return true;
+    }
+
+    std::vector<uint32_t> hardClusters;
+    std::vector<uint32_t> ordered = Tipsify(indices, indexCount, vertexCount, hardClusters);
+    std::vector<uint32_t> clusters = SplitClusters(ordered, vertexCount, hardClusters, overdrawThreshold);
+
+    // Area-weighted centroid and normal per cluster, and for the whole mesh
+    std::vector<glm::vec3> centroids(clusters.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(clusters.size(), glm::vec3(0.0f));
+    std::vector<float> areas(clusters.size(), 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusters.size(); c++) {
+        uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+        for (uint32_t t = clusters[c]; t < end; t++) {
+            const glm::vec3& a = vertices[ordered[t * 3]].position;
+            const glm::vec3& b = vertices[ordered[t * 3 + 1]].position;
+            const glm::vec3& d = vertices[ordered[t * 3 + 2]].position;
+            glm::vec3 normal = glm::cross(b - a, d - a);
+            float area = glm::length(normal);
+            centroids[c] += (a + b + d) * (area / 3.0f);
+            normals[c] += normal;
+            areas[c] += area;
+        }
+        meshCentroid += centroids[c];
+        meshArea += areas[c];
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    // Clusters facing away from the mesh centre are likely in front, so they
+    // draw first and later ones fail the depth test
+    std::vector<float> keys(clusters.size(), 0.0f);
+    for (size_t c = 0; c < clusters.size(); c++) {
+        float normalLength = glm::length(normals[c]);
+        if (areas[c] > 0.0f && normalLength > 0.0f) {
+            keys[c] = glm::dot(centroids[c] / areas[c] - meshCentroid, normals[c] / normalLength);
+        }
+    }
+
+    std::vector<uint32_t> order(clusters.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+    size_t written = 0;
+    for (uint32_t c : order) {
+        uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : static_cast<uint32_t>(triangleCount);
+        for (size_t i = size_t(clusters[c]) * 3; i < size_t(end) * 3; i++) {
+            indices[written++] = ordered[i];
+        }
+    }
+    return true;
+}
+
+template<typename VertexType>
+bool OptimizeVertexFetch(std::vector<VertexType>& vertices, uint32_t* indices, size_t indexCount) {
+    if (!HasValidIndices(indices, indexCount, vertices.size())) {
+        return false;
+    }
+
+    std::vector<uint32_t> remap(vertices.size(), kNoVertex);
+    uint32_t nextVertex = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t& slot = remap[indices[i]];
+        if (slot == kNoVertex) {
+            slot = nextVertex++;
+        }
+        indices[i] = slot;
+    }
+
+    std::vector<VertexType> reordered(nextVertex);
+    for (size_t v = 0; v < vertices.size(); v++) {
+        if (remap[v] != kNoVertex) {
+            reordered[remap[v]] = vertices[v];
+        }
+    }
+    vertices.swap(reordered);
+    return true;
+}
+
+template bool OptimizeVertexFetch<Vertex>(std::vector<Vertex>&, uint32_t*, size_t);
+template bool OptimizeVertexFetch<uint32_t>(std::vector<uint32_t>&, uint32_t*, size_t);
+
+} // namespace aero_boar
@@ -0,0 +1,474 @@
+#include "assets/meshopt_decoder.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace aero_boar {
+
+namespace {
+
+// Bitstream constants of the meshoptimizer codecs the extension specifies
+constexpr unsigned char kVertexHeader = 0xa0;
+constexpr unsigned char kIndexHeader = 0xe0;
+constexpr unsigned char kSequenceHeader = 0xd0;
+constexpr size_t kVertexBlockSizeBytes = 8192;
+constexpr size_t kVertexBlockMaxSize = 256;
+constexpr size_t kByteGroupSize = 16;
+constexpr size_t kByteGroupDecodeLimit = 24; // Largest encoded byte group
+constexpr size_t kTailMaxSize = 32;
+constexpr size_t kCodeAuxTableSize = 16;
+
+// Vertices per block, so one block of every byte of the vertex fits 8 KB
+size_t GetVertexBlockSize(size_t stride) {
+    size_t result = (kVertexBlockSizeBytes / stride) & ~(kByteGroupSize - 1);
+    return result < kVertexBlockMaxSize ? result : kVertexBlockMaxSize;
+}
+
+unsigned char Unzigzag8(unsigned char v) {
+    return static_cast<unsigned char>(-(v & 1) ^ (v >> 1));
+}
+
+// Sixteen values of 0, 2, 4 or 8 bits; all-ones values in the 2 and 4 bit
+// forms escape to a full byte stored after the group
+const unsigned char* DecodeByteGroup(const unsigned char* data, unsigned char* buffer, int bitsLog2) {
+    if (bitsLog2 == 0) {
+        std::memset(buffer, 0, kByteGroupSize);
+        return data;
+    }
+    if (bitsLog2 == 3) {
+        std::memcpy(buffer, data, kByteGroupSize);
+        return data + kByteGroupSize;
+    }
+
+    int bits = bitsLog2 == 1 ? 2 : 4;
+    unsigned int escape = (1u << bits) - 1;
+    size_t packedSize = kByteGroupSize * bits / 8;
+    const unsigned char* escapes = data + packedSize;
+    for (size_t i = 0; i < kByteGroupSize; i++) {
+        size_t bit = i * bits;
+        unsigned int value = (data[bit / 8] >> (8 - bits - bit % 8)) & escape;
+        buffer[i] = value == escape ? *escapes++ : static_cast<unsigned char>(value);
+    }
+    return escapes;
+}
+
+const unsigned char* DecodeBytes(const unsigned char* data, const unsigned char* dataEnd, unsigned char* buffer,
+                                 size_t bufferSize) {
+    // Two header bits per group, rounded up to whole bytes
+    const unsigned char* header = data;
+    size_t headerSize = (bufferSize / kByteGroupSize + 3) / 4;
+    if (size_t(dataEnd - data) < headerSize) {
+        return nullptr;
+    }
+    data += headerSize;
+
+    for (size_t i = 0; i < bufferSize; i += kByteGroupSize) {
+        // The stream ends in a tail of at least kTailMaxSize bytes, so this
+        // keeps every group read inside the source
+        if (size_t(dataEnd - data) < kByteGroupDecodeLimit) {
+            return nullptr;
+        }
+        size_t group = i / kByteGroupSize;
+        int bitsLog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+        data = DecodeByteGroup(data, buffer + i, bitsLog2);
+    }
+    return data;
+}
+
+// Each byte of the vertex is stored as its own stream of zigzag deltas
+// against the same byte of the previous vertex
+const unsigned char* DecodeVertexBlock(const unsigned char* data, const unsigned char* dataEnd,
+                                       unsigned char* vertices, size_t vertexCount, size_t stride,
+                                       unsigned char* lastVertex) {
+    unsigned char buffer[kVertexBlockMaxSize];
+    size_t alignedCount = (vertexCount + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+
+    for (size_t k = 0; k < stride; k++) {
+        data = DecodeBytes(data, dataEnd, buffer, alignedCount);
+        if (!data) {
+            return nullptr;
+        }
+        unsigned char previous = lastVertex[k];
+        for (size_t i = 0; i < vertexCount; i++) {
+            previous = static_cast<unsigned char>(Unzigzag8(buffer[i]) + previous);
+            vertices[i * stride + k] = previous;
+        }
+    }
+
+    std::memcpy(lastVertex, vertices + (vertexCount - 1) * stride, stride);
+    return data;
+}
+
+bool DecodeVertexBuffer(unsigned char* dst, size_t count, size_t stride, const unsigned char* source,
+                        size_t sourceSize, std::string& error) {
+    if (stride == 0 || stride > 256 || stride % 4 != 0) {
+        error = "attribute stride must be a multiple of 4 up to 256";
+        return false;
+    }
+    const unsigned char* data = source;
+    const unsigned char* dataEnd = source + sourceSize;
+    if (sourceSize < 1 + stride) {
+        error = "vertex stream truncated";
+        return false;
+    }
+    if ((*data & 0xf0) != kVertexHeader || (*data & 0x0f) > 0) {
+        error = "unsupported vertex stream version";
+        return false;
+    }
+    data++;
+
+    // The tail holds the vertex the first deltas are taken against
+    unsigned char lastVertex[256];
+    std::memcpy(lastVertex, dataEnd - stride, stride);
+
+    size_t blockSize = GetVertexBlockSize(stride);
+    for (size_t offset = 0; offset < count; offset += blockSize) {
+        size_t vertexCount = offset + blockSize < count ? blockSize : count - offset;
+        data = DecodeVertexBlock(data, dataEnd, dst + offset * stride, vertexCount, stride, lastVertex);
+        if (!data) {
+            error = "vertex stream truncated";
+            return false;
+        }
+    }
+
+    size_t tailSize = stride < kTailMaxSize ? kTailMaxSize : stride;
+    if (size_t(dataEnd - data) != tailSize) {
+        error = "vertex stream has trailing data";
+        return false;
+    }
+    return true;
+}
+
+unsigned int DecodeVByte(const unsigned char*& data) {
+    unsigned char lead = *data++;
+    if (lead < 128) {
+        return lead;
+    }
+    unsigned int result = lead & 127;
+    unsigned int shift = 7;
+    for (int i = 0; i < 4; i++) {
+        unsigned char group = *data++;
+        result |= unsigned(group & 127) << shift;
+        shift += 7;
+        if (group < 128) {
+            break;
+        }
+    }
+    return result;
+}
+
+unsigned int DecodeIndexDelta(const unsigned char*& data, unsigned int last) {
+    unsigned int v = DecodeVByte(data);
+    return last + ((v >> 1) ^ (0u - (v & 1)));
+}
+
+void WriteIndex(unsigned char* dst, size_t i, size_t indexSize, unsigned int index) {
+    if (indexSize == 2) {
+        uint16_t value = static_cast<uint16_t>(index);
+        std::memcpy(dst + i * 2, &value, 2);
+    } else {
+        std::memcpy(dst + i * 4, &index, 4);
+    }
+}
+
+// Ring buffers of recently seen vertices and edges; index 0 is the newest
+struct IndexFifos {
+    unsigned int vertices[16];
+    unsigned int edges[16][2];
+    size_t vertexOffset = 0;
+    size_t edgeOffset = 0;
+
+    IndexFifos() {
+        std::memset(vertices, 0xff, sizeof(vertices));
+        std::memset(edges, 0xff, sizeof(edges));
+    }
+
+    void PushVertex(unsigned int v, bool condition = true) {
+        vertices[vertexOffset] = v;
+        vertexOffset = (vertexOffset + (condition ? 1 : 0)) & 15;
+    }
+
+    void PushEdge(unsigned int a, unsigned int b) {
+        edges[edgeOffset][0] = a;
+        edges[edgeOffset][1] = b;
+        edgeOffset = (edgeOffset + 1) & 15;
+    }
+};
+
+bool DecodeIndexBuffer(unsigned char* dst, size_t count, size_t indexSize, const unsigned char* source,
+                       size_t sourceSize, std::string& error) {
+    if (count % 3 != 0) {
+        error = "triangle index count is not a multiple of 3";
+        return false;
+    }
+    // Header, one code per triangle and the code table
+    if (sourceSize < 1 + count / 3 + kCodeAuxTableSize) {
+        error = "index stream truncated";
+        return false;
+    }
+    int version = source[0] & 0x0f;
+    if ((source[0] & 0xf0) != kIndexHeader || version > 1) {
+        error = "unsupported index stream version";
+        return false;
+    }
+
+    IndexFifos fifos;
+    unsigned int next = 0;
+    unsigned int last = 0;
+    int fecMax = version >= 1 ? 13 : 15;
+
+    const unsigned char* code = source + 1;
+    const unsigned char* data = code + count / 3;
+    const unsigned char* dataSafeEnd = source + sourceSize - kCodeAuxTableSize;
+    const unsigned char* codeAuxTable = dataSafeEnd;
+
+    for (size_t i = 0; i < count; i += 3) {
+        // A triangle reads at most 16 data bytes, which the code table after
+        // dataSafeEnd keeps inside the source
+        if (data > dataSafeEnd) {
+            error = "index stream truncated";
+            return false;
+        }
+
+        unsigned char codeTri = *code++;
+        unsigned int a, b, c;
+        if (codeTri < 0xf0) {
+            // Recent edge plus a new, recent, adjacent or free vertex
+            size_t fe = codeTri >> 4;
+            a = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][0];
+            b = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][1];
+            int fec = codeTri & 15;
+            if (fec < fecMax) {
+                c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - 1 - fec) & 15];
+                fifos.PushVertex(c, fec == 0);
+            } else {
+                // 13 and 14 step from the last free vertex by -1 and +1
+                c = fec != 15 ? last + (fec - (fec ^ 3)) : DecodeIndexDelta(data, last);
+                last = c;
+                fifos.PushVertex(c);
+            }
+            fifos.PushEdge(c, b);
+            fifos.PushEdge(a, c);
+        } else {
+            // Three vertices, described by a table entry or an explicit byte
+            bool explicitCode = codeTri >= 0xfe;
+            unsigned char codeAux = explicitCode ? *data++ : codeAuxTable[codeTri & 15];
+            int feb = codeAux >> 4;
+            int fec = codeAux & 15;
+            if (explicitCode && codeAux == 0) {
+                next = 0;
+            }
+
+            a = codeTri == 0xff ? 0 : next++;
+            b = feb == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - feb) & 15];
+            c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - fec) & 15];
+            if (explicitCode) {
+                if (codeTri == 0xff) {
+                    last = a = DecodeIndexDelta(data, last);
+                }
+                if (feb == 15) {
+                    last = b = DecodeIndexDelta(data, last);
+                }
+                if (fec == 15) {
+                    last = c = DecodeIndexDelta(data, last);
+                }
+            }
+
+            fifos.PushVertex(a);
+            fifos.PushVertex(b, feb == 0 || (explicitCode && feb == 15));
+            fifos.PushVertex(c, fec == 0 || (explicitCode && fec == 15));
+            fifos.PushEdge(b, a);
+            fifos.PushEdge(c, b);
+            fifos.PushEdge(a, c);
+        }
+
+        WriteIndex(dst, i + 0, indexSize, a);
+        WriteIndex(dst, i + 1, indexSize, b);
+        WriteIndex(dst, i + 2, indexSize, c);
+    }
+
+    if (data != dataSafeEnd) {
+        error = "index stream has trailing data";
+        return false;
+    }
+    return true;
+}
+
+// Each index is a zigzag delta against one of two running baselines
+bool DecodeIndexSequence(unsigned char* dst, size_t count, size_t indexSize, const unsigned char* source,
+                         size_t sourceSize, std::string& error) {
+    // Header, at least a byte per index and the 4-byte tail
+    if (sourceSize < 1 + count + 4) {
+        error = "index sequence truncated";
+        return false;
+    }
+    if ((source[0] & 0xf0) != kSequenceHeader || (source[0] & 0x0f) > 1) {
+        error = "unsupported index sequence version";
+        return false;
+    }
+
+    const unsigned char* data = source + 1;
+    const unsigned char* dataSafeEnd = source + sourceSize - 4;
+    unsigned int last[2] = {};
+    for (size_t i = 0; i < count; i++) {
+        // An index reads at most 5 bytes, which the tail keeps inside the source
+        if (data >= dataSafeEnd) {
+            error = "index sequence truncated";
+            return false;
+        }
+        unsigned int v = DecodeVByte(data);
+        unsigned int baseline = v & 1;
+        v >>= 1;
+        last[baseline] += (v >> 1) ^ (0u - (v & 1));
+        WriteIndex(dst, i, indexSize, last[baseline]);
+    }
+
+    if (data != dataSafeEnd) {
+        error = "index sequence has trailing data";
+        return false;
+    }
+    return true;
+}
+
+int RoundToInt(float v) {
+    return static_cast<int>(v + (v >= 0.0f ? 0.5f : -0.5f));
+}
+
+// x and y are octahedral coordinates and z holds the scale, so the result
+// is renormalized to the full range of the component type
+template <typename T>
+void DecodeOctahedralFilter(unsigned char* data, size_t count) {
+    const float maxValue = float((1 << (sizeof(T) * 8 - 1)) - 1);
+    for (size_t i = 0; i < count; i++) {
+        T components[4];
+        std::memcpy(components, data + i * sizeof(components), sizeof(components));
+
+        float x = float(components[0]);
+        float y = float(components[1]);
+        float z = float(components[2]) - std::fabs(x) - std::fabs(y);
+        float t = z < 0.0f ? z : 0.0f;
+        x += x >= 0.0f ? t : -t;
+        y += y >= 0.0f ? t : -t;
+
+        float s = maxValue / std::sqrt(x * x + y * y + z * z);
+        components[0] = static_cast<T>(RoundToInt(x * s));
+        components[1] = static_cast<T>(RoundToInt(y * s));
+        components[2] = static_cast<T>(RoundToInt(z * s));
+        std::memcpy(data + i * sizeof(components), components, sizeof(components));
+    }
+}
+
+// Three smallest components plus the index of the largest, which is rebuilt
+// from unit length; the low bits of the fourth component store that index
+void DecodeQuaternionFilter(unsigned char* data, size_t count) {
+    const float scale = 1.0f / std::sqrt(2.0f);
+    for (size_t i = 0; i < count; i++) {
+        int16_t components[4];
+        std::memcpy(components, data + i * sizeof(components), sizeof(components));
+
+        float ss = scale / float(components[3] | 3);
+        float x = float(components[0]) * ss;
+        float y = float(components[1]) * ss;
+        float z = float(components[2]) * ss;
+        float ww = 1.0f - x * x - y * y - z * z;
+        float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+        int largest = components[3] & 3;
+        int16_t decoded[4];
+        decoded[(largest + 1) & 3] = static_cast<int16_t>(RoundToInt(x * 32767.0f));
+        decoded[(largest + 2) & 3] = static_cast<int16_t>(RoundToInt(y * 32767.0f));
+        decoded[(largest + 3) & 3] = static_cast<int16_t>(RoundToInt(z * 32767.0f));
+        decoded[largest] = static_cast<int16_t>(RoundToInt(w * 32767.0f));
+        std::memcpy(data + i * sizeof(decoded), decoded, sizeof(decoded));
+    }
+}
+
+// 24-bit signed mantissa and 8-bit signed exponent per float
+void DecodeExponentialFilter(unsigned char* data, size_t valueCount) {
+    for (size_t i = 0; i < valueCount; i++) {
+        uint32_t v;
+        std::memcpy(&v, data + i * 4, 4);
+        int32_t mantissa = static_cast<int32_t>(v << 8) >> 8;
+        int32_t exponent = static_cast<int32_t>(v) >> 24;
+        float result = std::ldexp(float(mantissa), exponent);
+        std::memcpy(data + i * 4, &result, 4);
+    }
+}
+
+} // namespace
+
+bool ParseMeshoptMode(const std::string& name, MeshoptMode& mode) {
+    if (name == "ATTRIBUTES") {
+        mode = MeshoptMode::Attributes;
+    } else if (name == "TRIANGLES") {
+        mode = MeshoptMode::Triangles;
+    } else if (name == "INDICES") {
+        mode = MeshoptMode::Indices;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool ParseMeshoptFilter(const std::string& name, MeshoptFilter& filter) {
+    if (name == "NONE") {
+        filter = MeshoptFilter::None;
+    } else if (name == "OCTAHEDRAL") {
+        filter = MeshoptFilter::Octahedral;
+    } else if (name == "QUATERNION") {
+        filter = MeshoptFilter::Quaternion;
+    } else if (name == "EXPONENTIAL") {
+        filter = MeshoptFilter::Exponential;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool DecodeMeshoptBufferView(const unsigned char* source, size_t sourceSize, size_t count, size_t stride,
+                             MeshoptMode mode, MeshoptFilter filter, unsigned char* dst, std::string& error) {
+    if (mode != MeshoptMode::Attributes) {
+        if (stride != 2 && stride != 4) {
+            error = "index stride must be 2 or 4";
+            return false;
+        }
+        if (filter != MeshoptFilter::None) {
+            error = "filters apply to attributes only";
+            return false;
+        }
+        return mode == MeshoptMode::Triangles ? DecodeIndexBuffer(dst, count, stride, source, sourceSize, error)
+                                              : DecodeIndexSequence(dst, count, stride, source, sourceSize, error);
+    }
+
+    if (!DecodeVertexBuffer(dst, count, stride, source, sourceSize, error)) {
+        return false;
+    }
+
+    switch (filter) {
+    case MeshoptFilter::None:
+        break;
+    case MeshoptFilter::Octahedral:
+        if (stride == 4) {
+            DecodeOctahedralFilter<int8_t>(dst, count);
+        } else if (stride == 8) {
+            DecodeOctahedralFilter<int16_t>(dst, count);
+        } else {
+            error = "octahedral filter needs a stride of 4 or 8";
+            return false;
+        }
+        break;
+    case MeshoptFilter::Quaternion:
+        if (stride != 8) {
+            error = "quaternion filter needs a stride of 8";
+            return false;
+        }
+        DecodeQuaternionFilter(dst, count);
+        break;
+    case MeshoptFilter::Exponential:
+        DecodeExponentialFilter(dst, count * stride / 4);
+        break;
+    }
+    return true;
+}
+
+} // namespace aero_boar
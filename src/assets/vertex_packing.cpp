@@ -0,0 +1,114 @@
+#include "assets/vertex_packing.hpp"
+#include <glm/gtc/packing.hpp>
+#include <cmath>
+
+namespace aero_boar {
+
+namespace {
+
+constexpr float kSnorm16Max = 32767.0f;
+
+// Half floats resolve steps of 1/1024 or finer up to this magnitude; tiling
+// UVs beyond it keep full precision
+constexpr float kMaxPackedTexCoord = 2.0f;
+
+// Octahedral mapping of a unit vector onto [-1, 1]^2
+glm::vec2 EncodeOctahedral(glm::vec3 n) {
+    float length = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (!(length > 0.0f)) {
+        return glm::vec2(0.0f); // Decodes to +Z, the loader's default normal
+    }
+    n /= length;
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0.0f) {
+        e = glm::vec2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return e;
+}
+
+int16_t PackSnorm16(float value) {
+    return static_cast<int16_t>(glm::packSnorm1x16(value));
+}
+
+} // namespace
+
+uint32_t GetVertexStride(VertexFormat format) {
+    switch (format) {
+        case VertexFormat::Packed: return sizeof(PackedVertex);
+        case VertexFormat::Skinned: return sizeof(SkinnedVertex);
+        default: return sizeof(Vertex);
+    }
+}
+
+bool PackVertices(const Vertex* vertices, size_t count, float positionTolerance,
+                  std::vector<PackedVertex>& packed, PositionQuantization& quantization) {
+    if (count == 0) {
+        return false;
+    }
+
+    glm::vec3 minPosition = vertices[0].position;
+    glm::vec3 maxPosition = vertices[0].position;
+    for (size_t i = 0; i < count; i++) {
+        const Vertex& vertex = vertices[i];
+        minPosition = glm::min(minPosition, vertex.position);
+        maxPosition = glm::max(maxPosition, vertex.position);
+
+        // Negated comparisons also reject NaNs
+        if (!(std::abs(vertex.texCoord.x) <= kMaxPackedTexCoord) ||
+            !(std::abs(vertex.texCoord.y) <= kMaxPackedTexCoord)) {
+            return false;
+        }
+        for (int c = 0; c < 4; c++) {
+            if (!(vertex.color[c] >= 0.0f && vertex.color[c] <= 1.0f)) {
+                return false;
+            }
+        }
+    }
+
+    // Rounding to the nearest snorm step moves a position by at most half a step
+    glm::vec3 halfExtent = (maxPosition - minPosition) * 0.5f;
+    for (int c = 0; c < 3; c++) {
+        if (!std::isfinite(halfExtent[c]) || halfExtent[c] / kSnorm16Max * 0.5f > positionTolerance) {
+            return false;
+        }
+    }
+
+    quantization.offset = minPosition + halfExtent;
+    quantization.scale = halfExtent;
+
+    // Flat axes quantize to zero and decode to the offset alone
+    glm::vec3 inverseScale(0.0f);
+    for (int c = 0; c < 3; c++) {
+        if (halfExtent[c] > 0.0f) {
+            inverseScale[c] = 1.0f / halfExtent[c];
+        }
+    }
+
+    packed.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const Vertex& vertex = vertices[i];
+        PackedVertex& out = packed[i];
+
+        glm::vec3 position = (vertex.position - quantization.offset) * inverseScale;
+        out.position[0] = PackSnorm16(position.x);
+        out.position[1] = PackSnorm16(position.y);
+        out.position[2] = PackSnorm16(position.z);
+        out.position[3] = 0;
+
+        glm::vec2 normal = EncodeOctahedral(vertex.normal);
+        out.normal[0] = PackSnorm16(normal.x);
+        out.normal[1] = PackSnorm16(normal.y);
+
+        out.texCoord[0] = glm::packHalf1x16(vertex.texCoord.x);
+        out.texCoord[1] = glm::packHalf1x16(vertex.texCoord.y);
+
+        for (int c = 0; c < 4; c++) {
+            out.color[c] = static_cast<uint8_t>(std::lround(vertex.color[c] * 255.0f));
+        }
+    }
+
+    return true;
+}
+
+} // namespace aero_boar
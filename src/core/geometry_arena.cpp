@@ -0,0 +1,434 @@
+#include "core/geometry_arena.hpp"
+#include "core/transfer_manager.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+namespace aero_boar {
+
+void GeometryArena::FreeList::Reset(uint64_t capacity) {
+    m_blocks.clear();
+    if (capacity > 0) {
+        m_blocks[0] = capacity;
+    }
+    m_freeCount = capacity;
+}
+
+bool GeometryArena::FreeList::Allocate(uint64_t count, uint64_t& offset) {
+    // Best fit keeps large blocks intact for large meshes
+    auto best = m_blocks.end();
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+        if (it->second >= count && (best == m_blocks.end() || it->second < best->second)) {
+            best = it;
+            if (it->second == count) {
+                break;
+            }
+        }
+    }
+
+    if (best == m_blocks.end()) {
+        return false;
+    }
+
+    offset = best->first;
+    uint64_t remaining = best->second - count;
+    m_blocks.erase(best);
+    if (remaining > 0) {
+        m_blocks[offset + count] = remaining;
+    }
+    m_freeCount -= count;
+    return true;
+}
+
+void GeometryArena::FreeList::Free(uint64_t offset, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    m_freeCount += count;
+
+    auto next = m_blocks.lower_bound(offset);
+
+    // Merge with the block that ends where this one starts
+    if (next != m_blocks.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            count += previous->second;
+            m_blocks.erase(previous);
+        }
+    }
+
+    // Merge with the block that starts where this one ends
+    if (next != m_blocks.end() && offset + count == next->first) {
+        count += next->second;
+        m_blocks.erase(next);
+    }
+
+    m_blocks[offset] = count;
+}
+
+uint64_t GeometryArena::FreeList::GetLargestBlock() const {
+    uint64_t largest = 0;
+    for (const auto& [offset, count] : m_blocks) {
+        largest = std::max(largest, count);
+    }
+    return largest;
+}
+
+GeometryArena::GeometryArena(VkDevice device, VmaAllocator allocator, TransferManager& transferManager,
+                             uint32_t vertexStride, uint32_t framesInFlight, const GeometryArenaConfig& config)
+    : m_device(device), m_allocator(allocator), m_transferManager(transferManager),
+      m_vertexStride(vertexStride), m_framesInFlight(framesInFlight), m_config(config) {
+}
+
+GeometryArena::~GeometryArena() {
+    Shutdown();
+}
+
+bool GeometryArena::Initialize() {
+    try {
+        m_vertexCapacity = m_config.vertexCapacity / m_vertexStride;
+        m_indexCapacity = m_config.indexCapacity / sizeof(uint32_t);
+
+        if (!CreateBuffers(m_vertexBuffer, m_vertexAllocation, m_indexBuffer, m_indexAllocation)) {
+            std::cerr << "Failed to create geometry arena buffers" << std::endl;
+            return false;
+        }
+
+        m_vertexFreeList.Reset(m_vertexCapacity);
+        m_indexFreeList.Reset(m_indexCapacity);
+
+        std::cout << "Geometry arena: " << m_vertexCapacity << " vertices, "
+                  << m_indexCapacity << " indices" << std::endl;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "GeometryArena initialization failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void GeometryArena::Shutdown() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& retired : m_retiredBuffers) {
+        vmaDestroyBuffer(m_allocator, retired.buffer, retired.allocation);
+    }
+    m_retiredBuffers.clear();
+
+    if (m_vertexBuffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(m_allocator, m_vertexBuffer, m_vertexAllocation);
+        m_vertexBuffer = VK_NULL_HANDLE;
+        m_vertexAllocation = VK_NULL_HANDLE;
+    }
+    if (m_indexBuffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(m_allocator, m_indexBuffer, m_indexAllocation);
+        m_indexBuffer = VK_NULL_HANDLE;
+        m_indexAllocation = VK_NULL_HANDLE;
+    }
+
+    m_allocations.clear();
+    m_freeHandles.clear();
+    m_pendingFrees.clear();
+    m_uploadsInFlight = 0;
+}
+
+bool GeometryArena::CreateBuffers(VkBuffer& vertexBuffer, VmaAllocation& vertexAllocation,
+                                  VkBuffer& indexBuffer, VmaAllocation& indexAllocation) {
+    // TRANSFER_SRC so compaction can copy live ranges out
+    if (!m_transferManager.CreateStaticBuffer(m_vertexCapacity * m_vertexStride,
+                                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                                  m_config.vertexUsage,
+                                              vertexBuffer, vertexAllocation)) {
+        return false;
+    }
+
+    if (!m_transferManager.CreateStaticBuffer(m_indexCapacity * sizeof(uint32_t),
+                                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                                  m_config.indexUsage,
+                                              indexBuffer, indexAllocation)) {
+        vmaDestroyBuffer(m_allocator, vertexBuffer, vertexAllocation);
+        vertexBuffer = VK_NULL_HANDLE;
+        vertexAllocation = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
+}
+
+GeometryHandle GeometryArena::Allocate(const void* vertices, uint32_t vertexCount,
+                                       const uint32_t* indices, uint32_t indexCount, TransferBatch& batch) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_vertexBuffer == VK_NULL_HANDLE || vertexCount == 0 || indexCount == 0) {
+        return kInvalidGeometryHandle;
+    }
+
+    Allocation allocation;
+    allocation.vertexCount = vertexCount;
+    allocation.indexCount = indexCount;
+
+    if (!m_vertexFreeList.Allocate(vertexCount, allocation.vertexOffset)) {
+        m_compactionRequested = m_vertexFreeList.GetFreeCount() >= vertexCount;
+        std::cerr << "Geometry arena out of vertex space (" << vertexCount << " vertices requested)" << std::endl;
+        return kInvalidGeometryHandle;
+    }
+
+    if (!m_indexFreeList.Allocate(indexCount, allocation.firstIndex)) {
+        m_vertexFreeList.Free(allocation.vertexOffset, vertexCount);
+        m_compactionRequested = m_indexFreeList.GetFreeCount() >= indexCount;
+        std::cerr << "Geometry arena out of index space (" << indexCount << " indices requested)" << std::endl;
+        return kInvalidGeometryHandle;
+    }
+
+    allocation.live = true;
+    allocation.resident = false;
+
+    GeometryHandle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+        m_allocations[handle - 1] = allocation;
+    } else {
+        m_allocations.push_back(allocation);
+        handle = static_cast<GeometryHandle>(m_allocations.size());
+    }
+    m_uploadsInFlight++;
+
+    batch.AddBufferCopy(m_vertexBuffer, m_vertexAllocation, vertices,
+                        static_cast<size_t>(vertexCount) * m_vertexStride,
+                        allocation.vertexOffset * m_vertexStride);
+    batch.AddBufferCopy(m_indexBuffer, m_indexAllocation, indices,
+                        static_cast<size_t>(indexCount) * sizeof(uint32_t),
+                        allocation.firstIndex * sizeof(uint32_t));
+
+    return handle;
+}
+
+void GeometryArena::MarkResident(GeometryHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (handle == kInvalidGeometryHandle || handle > m_allocations.size()) {
+        return;
+    }
+
+    Allocation& allocation = m_allocations[handle - 1];
+    if (allocation.live && !allocation.resident) {
+        allocation.resident = true;
+        m_uploadsInFlight--;
+    }
+}
+
+void GeometryArena::Free(GeometryHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (handle == kInvalidGeometryHandle || handle > m_allocations.size()) {
+        return;
+    }
+
+    Allocation& allocation = m_allocations[handle - 1];
+    if (!allocation.live) {
+        return;
+    }
+
+    // Callers wait for the upload before freeing, so nothing writes the range anymore
+    if (!allocation.resident) {
+        m_uploadsInFlight--;
+    }
+    allocation.live = false;
+
+    // Frames already recorded may still draw from the range
+    PendingFree pending;
+    pending.handle = handle;
+    pending.framesLeft = m_framesInFlight;
+    m_pendingFrees.push_back(pending);
+}
+
+bool GeometryArena::GetRange(GeometryHandle handle, GeometryRange& range) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (handle == kInvalidGeometryHandle || handle > m_allocations.size()) {
+        return false;
+    }
+
+    const Allocation& allocation = m_allocations[handle - 1];
+    if (!allocation.live) {
+        return false;
+    }
+
+    range.vertexOffset = static_cast<int32_t>(allocation.vertexOffset);
+    range.vertexCount = static_cast<uint32_t>(allocation.vertexCount);
+    range.firstIndex = static_cast<uint32_t>(allocation.firstIndex);
+    range.indexCount = static_cast<uint32_t>(allocation.indexCount);
+    return true;
+}
+
+void GeometryArena::ReleaseRanges(Allocation& allocation) {
+    m_vertexFreeList.Free(allocation.vertexOffset, allocation.vertexCount);
+    m_indexFreeList.Free(allocation.firstIndex, allocation.indexCount);
+    allocation = Allocation{};
+}
+
+void GeometryArena::BeginFrame() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto pending = m_pendingFrees.begin();
+    while (pending != m_pendingFrees.end()) {
+        if (pending->framesLeft == 0) {
+            ReleaseRanges(m_allocations[pending->handle - 1]);
+            m_freeHandles.push_back(pending->handle);
+            pending = m_pendingFrees.erase(pending);
+        } else {
+            pending->framesLeft--;
+            ++pending;
+        }
+    }
+
+    auto retired = m_retiredBuffers.begin();
+    while (retired != m_retiredBuffers.end()) {
+        if (retired->framesLeft == 0) {
+            vmaDestroyBuffer(m_allocator, retired->buffer, retired->allocation);
+            retired = m_retiredBuffers.erase(retired);
+        } else {
+            retired->framesLeft--;
+            ++retired;
+        }
+    }
+}
+
+bool GeometryArena::IsFragmented() const {
+    // Lots of free space that is only available as small holes
+    auto fragmented = [this](const FreeList& freeList, uint64_t capacity) {
+        uint64_t freeCount = freeList.GetFreeCount();
+        return freeCount >= static_cast<uint64_t>(capacity * m_config.compactionThreshold) &&
+               freeList.GetLargestBlock() < freeCount / 2;
+    };
+    return fragmented(m_vertexFreeList, m_vertexCapacity) || fragmented(m_indexFreeList, m_indexCapacity);
+}
+
+bool GeometryArena::RecordCompaction(VkCommandBuffer commandBuffer) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Uploads in flight were recorded against the current buffers and offsets
+    if (m_vertexBuffer == VK_NULL_HANDLE || m_uploadsInFlight > 0 ||
+        (!m_compactionRequested && !IsFragmented())) {
+        return false;
+    }
+
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VmaAllocation vertexAllocation = VK_NULL_HANDLE;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VmaAllocation indexAllocation = VK_NULL_HANDLE;
+    if (!CreateBuffers(vertexBuffer, vertexAllocation, indexBuffer, indexAllocation)) {
+        std::cerr << "Failed to create buffers for geometry compaction" << std::endl;
+        m_compactionRequested = false;
+        return false;
+    }
+
+    // Ranges waiting out in-flight frames are dropped: those frames keep
+    // reading the old buffers, which are retired below
+    for (const auto& pending : m_pendingFrees) {
+        m_allocations[pending.handle - 1] = Allocation{};
+        m_freeHandles.push_back(pending.handle);
+    }
+    m_pendingFrees.clear();
+
+    // Pack live ranges from the start of the new buffers
+    std::vector<VkBufferCopy> vertexCopies;
+    std::vector<VkBufferCopy> indexCopies;
+    uint64_t vertexCursor = 0;
+    uint64_t indexCursor = 0;
+    for (auto& allocation : m_allocations) {
+        if (!allocation.live) {
+            continue;
+        }
+
+        VkBufferCopy vertexCopy{};
+        vertexCopy.srcOffset = allocation.vertexOffset * m_vertexStride;
+        vertexCopy.dstOffset = vertexCursor * m_vertexStride;
+        vertexCopy.size = allocation.vertexCount * m_vertexStride;
+        vertexCopies.push_back(vertexCopy);
+
+        VkBufferCopy indexCopy{};
+        indexCopy.srcOffset = allocation.firstIndex * sizeof(uint32_t);
+        indexCopy.dstOffset = indexCursor * sizeof(uint32_t);
+        indexCopy.size = allocation.indexCount * sizeof(uint32_t);
+        indexCopies.push_back(indexCopy);
+
+        allocation.vertexOffset = vertexCursor;
+        allocation.firstIndex = indexCursor;
+        vertexCursor += allocation.vertexCount;
+        indexCursor += allocation.indexCount;
+    }
+
+    // Earlier uploads and draws against the old buffers come first
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    if (!vertexCopies.empty()) {
+        vkCmdCopyBuffer(commandBuffer, m_vertexBuffer, vertexBuffer,
+                        static_cast<uint32_t>(vertexCopies.size()), vertexCopies.data());
+        vkCmdCopyBuffer(commandBuffer, m_indexBuffer, indexBuffer,
+                        static_cast<uint32_t>(indexCopies.size()), indexCopies.data());
+    }
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // The old buffers stay alive until every frame that may use them retires
+    m_retiredBuffers.push_back({m_vertexBuffer, m_vertexAllocation, m_framesInFlight});
+    m_retiredBuffers.push_back({m_indexBuffer, m_indexAllocation, m_framesInFlight});
+
+    m_vertexBuffer = vertexBuffer;
+    m_vertexAllocation = vertexAllocation;
+    m_indexBuffer = indexBuffer;
+    m_indexAllocation = indexAllocation;
+
+    m_vertexFreeList.Reset(m_vertexCapacity);
+    m_indexFreeList.Reset(m_indexCapacity);
+    uint64_t packedOffset = 0;
+    if (vertexCursor > 0) {
+        m_vertexFreeList.Allocate(vertexCursor, packedOffset);
+    }
+    if (indexCursor > 0) {
+        m_indexFreeList.Allocate(indexCursor, packedOffset);
+    }
+
+    m_compactionRequested = false;
+    std::cout << "Geometry arena compacted: " << vertexCursor << " vertices, "
+              << indexCursor << " indices live" << std::endl;
+    return true;
+}
+
+void GeometryArena::Bind(VkCommandBuffer commandBuffer) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_vertexBuffer == VK_NULL_HANDLE) {
+        return;
+    }
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+}
+
+void GeometryArena::BindIndexBuffer(VkCommandBuffer commandBuffer) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_indexBuffer != VK_NULL_HANDLE) {
+        vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    }
+}
+
+VkBuffer GeometryArena::GetVertexBuffer() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_vertexBuffer;
+}
+
+VkBuffer GeometryArena::GetIndexBuffer() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_indexBuffer;
+}
+
+} // namespace aero_boar
@@ -1,6 +1,9 @@
 #define VMA_IMPLEMENTATION
 #include "core/renderer.hpp"
 #include "assets/gltf_loader.hpp"
+#include "core/transfer_manager.hpp"
+#include "core/residency_manager.hpp"
+#include "core/skinning_system.hpp"
 #include "input/input_manager.hpp"
 #include "core/window_interface.hpp"
 #include <vulkan/vulkan.hpp>
@@ -9,6 +12,7 @@
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
+#include <filesystem>
 #ifdef _WIN32
 #include <windows.h>
 #include <GLFW/glfw3.h>
@@ -122,12 +126,37 @@ bool Renderer::Initialize(IWindow* window) {
         }
 
         // Initialize glTF loader
-        m_gltfLoader = std::make_unique<GltfLoader>(m_device, m_physicalDevice, m_allocator);
+        TransferConfig transferConfig = TransferConfig::LoadFromFile(GetExecutableDirectory() + "/config/transfer.json");
+        AssetConfig assetConfig = AssetConfig::LoadFromFile(GetExecutableDirectory() + "/config/assets.json");
+        if (!assetConfig.meshCacheDirectory.empty() &&
+            std::filesystem::path(assetConfig.meshCacheDirectory).is_relative()) {
+            assetConfig.meshCacheDirectory = GetExecutableDirectory() + "/" + assetConfig.meshCacheDirectory;
+        }
+        TransferQueueInfo transferQueue;
+        transferQueue.queue = m_transferQueue;
+        transferQueue.familyIndex = m_transferQueueFamilyIndex;
+        transferQueue.graphicsFamilyIndex = m_graphicsQueueFamilyIndex;
+        transferQueue.submitMutex = m_transferQueue == m_graphicsQueue ? &m_queueSubmitMutex : nullptr;
+        m_gltfLoader = std::make_unique<GltfLoader>(m_device, m_physicalDevice, m_allocator,
+                                                    transferQueue, MAX_FRAMES_IN_FLIGHT, transferConfig, assetConfig);
         if (!m_gltfLoader->Initialize()) {
             std::cerr << "Failed to initialize glTF loader" << std::endl;
             return false;
         }
 
+        // Evicts least recently rendered models when VRAM runs short
+        ResidencyConfig residencyConfig = ResidencyConfig::LoadFromFile(GetExecutableDirectory() + "/config/residency.json");
+        m_residencyManager = std::make_unique<ResidencyManager>(m_allocator, *m_gltfLoader, MAX_FRAMES_IN_FLIGHT,
+                                                                residencyConfig);
+
+        // Poses animated instances and skins them all in one compute dispatch
+        m_skinningSystem = std::make_unique<SkinningSystem>(m_device, m_allocator, *m_gltfLoader,
+                                                            m_residencyManager.get(), MAX_FRAMES_IN_FLIGHT);
+        if (!m_skinningSystem->Initialize(ReadFile(GetExecutableDirectory() + "/shaders/skinning.comp.spv"))) {
+            std::cerr << "Failed to initialize skinning system" << std::endl;
+            return false;
+        }
+
         // Initialize input manager
         m_inputManager = std::make_unique<InputManager>();
         if (!m_inputManager->Initialize(m_window)) {
@@ -167,7 +196,15 @@ void Renderer::Shutdown() {
         }
 
         // Cleanup glTF loader first (it has its own Vulkan resources)
+        if (m_skinningSystem) {
+            m_skinningSystem->Shutdown();
+            m_skinningSystem.reset();
+        }
+        m_residencyManager.reset();
         if (m_gltfLoader) {
+            m_modelHandles.clear();
+            m_modelRequests.clear();
+            m_completedLoads.clear();
             m_gltfLoader->Shutdown();
             m_gltfLoader.reset();
         }
@@ -230,6 +267,10 @@ void Renderer::Shutdown() {
             vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
             m_graphicsPipeline = VK_NULL_HANDLE;
         }
+        if (m_packedGraphicsPipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(m_device, m_packedGraphicsPipeline, nullptr);
+            m_packedGraphicsPipeline = VK_NULL_HANDLE;
+        }
 
         // Cleanup pipeline layout
         if (m_pipelineLayout != VK_NULL_HANDLE) {
@@ -355,9 +396,22 @@ bool Renderer::CreateSurface() {
 
 bool Renderer::SelectPhysicalDevice() {
     vkb::PhysicalDeviceSelector selector(m_vkbInstance);
+
+    // Timeline semaphores back the transfer tickets; host query reset lets the
+    // transfer queue's timestamp queries be recycled without graphics commands
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.timelineSemaphore = VK_TRUE;
+    features12.hostQueryReset = VK_TRUE;
+
+    // Textures are sampled with anisotropic filtering across their mip chain
+    VkPhysicalDeviceFeatures features{};
+    features.samplerAnisotropy = VK_TRUE;
     
     auto phys_ret = selector.set_surface(m_surface)
                            .set_minimum_version(1, 3)
+                           .set_required_features(features)
+                           .set_required_features_12(features12)
                            .select();
     
     if (!phys_ret) {
@@ -367,11 +421,16 @@ bool Renderer::SelectPhysicalDevice() {
     
     m_vkbPhysicalDevice = phys_ret.value();
     m_physicalDevice = m_vkbPhysicalDevice.physical_device;
+
+    // Without it VMA can only estimate heap budgets from heap sizes
+    m_memoryBudgetSupported = m_vkbPhysicalDevice.enable_extension_if_present(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
     
     return true;
 }
 
 bool Renderer::CreateLogicalDevice() {
+    // Without custom queue descriptions vk-bootstrap creates one queue in every
+    // family, so dedicated transfer and compute queues are available if present
     vkb::DeviceBuilder device_builder(m_vkbPhysicalDevice);
     
     auto dev_ret = device_builder.build();
@@ -384,17 +443,49 @@ bool Renderer::CreateLogicalDevice() {
     m_vkbDevice = dev_ret.value();
     m_device = m_vkbDevice.device;
     m_graphicsQueue = m_vkbDevice.get_queue(vkb::QueueType::graphics).value();
+    m_graphicsQueueFamilyIndex = m_vkbDevice.get_queue_index(vkb::QueueType::graphics).value();
     m_presentQueue = m_vkbDevice.get_queue(vkb::QueueType::present).value();
+
+    SelectAsyncQueue(vkb::QueueType::transfer, m_transferQueue, m_transferQueueFamilyIndex);
+    SelectAsyncQueue(vkb::QueueType::compute, m_computeQueue, m_computeQueueFamilyIndex);
+
+    std::cout << "Queue families: graphics " << m_graphicsQueueFamilyIndex
+              << ", transfer " << m_transferQueueFamilyIndex
+              << ", compute " << m_computeQueueFamilyIndex << std::endl;
     
     return true;
 }
 
+void Renderer::SelectAsyncQueue(vkb::QueueType type, VkQueue& queue, uint32_t& familyIndex) {
+    // Prefer a dedicated family (e.g. a DMA copy engine), then any family
+    // separate from graphics, then share the graphics queue
+    auto dedicatedQueue = m_vkbDevice.get_dedicated_queue(type);
+    if (dedicatedQueue) {
+        queue = dedicatedQueue.value();
+        familyIndex = m_vkbDevice.get_dedicated_queue_index(type).value();
+        return;
+    }
+
+    auto separateQueue = m_vkbDevice.get_queue(type);
+    if (separateQueue) {
+        queue = separateQueue.value();
+        familyIndex = m_vkbDevice.get_queue_index(type).value();
+        return;
+    }
+
+    queue = m_graphicsQueue;
+    familyIndex = m_graphicsQueueFamilyIndex;
+}
+
 bool Renderer::CreateVMAAllocator() {
     VmaAllocatorCreateInfo allocatorInfo = {};
     allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_2;
     allocatorInfo.physicalDevice = m_physicalDevice;
     allocatorInfo.device = m_device;
     allocatorInfo.instance = m_instance;
+    if (m_memoryBudgetSupported) {
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
 
     VkResult result = vmaCreateAllocator(&allocatorInfo, &m_allocator);
     if (result != VK_SUCCESS) {
@@ -483,9 +574,11 @@ bool Renderer::CreateGraphicsPipeline() {
     // Load shaders
     std::string shaderDir = GetExecutableDirectory();
     auto vertShaderCode = ReadFile(shaderDir + "/shaders/pbr.vert.spv");
+    auto packedVertShaderCode = ReadFile(shaderDir + "/shaders/pbr_packed.vert.spv");
     auto fragShaderCode = ReadFile(shaderDir + "/shaders/pbr.frag.spv");
 
     VkShaderModule vertShaderModule = CreateShaderModule(vertShaderCode);
+    VkShaderModule packedVertShaderModule = CreateShaderModule(packedVertShaderCode);
     VkShaderModule fragShaderModule = CreateShaderModule(fragShaderCode);
 
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
@@ -536,6 +629,24 @@ bool Renderer::CreateGraphicsPipeline() {
     vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
     vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
+    // Packed variant: same locations, narrower formats (see PackedVertex)
+    VkVertexInputBindingDescription packedBindingDescription = bindingDescription;
+    packedBindingDescription.stride = sizeof(PackedVertex);
+
+    std::array<VkVertexInputAttributeDescription, 4> packedAttributeDescriptions = attributeDescriptions;
+    packedAttributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_SNORM;
+    packedAttributeDescriptions[0].offset = offsetof(PackedVertex, position);
+    packedAttributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+    packedAttributeDescriptions[1].offset = offsetof(PackedVertex, normal);
+    packedAttributeDescriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+    packedAttributeDescriptions[2].offset = offsetof(PackedVertex, texCoord);
+    packedAttributeDescriptions[3].format = VK_FORMAT_R8G8B8A8_UNORM;
+    packedAttributeDescriptions[3].offset = offsetof(PackedVertex, color);
+
+    VkPipelineVertexInputStateCreateInfo packedVertexInputInfo = vertexInputInfo;
+    packedVertexInputInfo.pVertexBindingDescriptions = &packedBindingDescription;
+    packedVertexInputInfo.pVertexAttributeDescriptions = packedAttributeDescriptions.data();
+
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
     inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
@@ -592,6 +703,7 @@ bool Renderer::CreateGraphicsPipeline() {
     if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
         std::cerr << "Failed to create descriptor set layout" << std::endl;
         vkDestroyShaderModule(m_device, fragShaderModule, nullptr);
+        vkDestroyShaderModule(m_device, packedVertShaderModule, nullptr);
         vkDestroyShaderModule(m_device, vertShaderModule, nullptr);
         return false;
     }
@@ -600,7 +712,15 @@ bool Renderer::CreateGraphicsPipeline() {
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutInfo.setLayoutCount = 1;
     pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
+
+    // Only the packed pipeline reads it; sharing the layout keeps the
+    // descriptor set bound across pipeline switches
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PackedMeshConstants);
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
     if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
         std::cerr << "Failed to create pipeline layout" << std::endl;
@@ -639,7 +759,15 @@ bool Renderer::CreateGraphicsPipeline() {
         return false;
     }
 
+    shaderStages[0].module = packedVertShaderModule;
+    pipelineInfo.pVertexInputState = &packedVertexInputInfo;
+    if (vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_packedGraphicsPipeline) != VK_SUCCESS) {
+        std::cerr << "Failed to create packed graphics pipeline" << std::endl;
+        return false;
+    }
+
     vkDestroyShaderModule(m_device, fragShaderModule, nullptr);
+    vkDestroyShaderModule(m_device, packedVertShaderModule, nullptr);
     vkDestroyShaderModule(m_device, vertShaderModule, nullptr);
 
     return true;
@@ -897,12 +1025,14 @@ void Renderer::RecreateSwapchain() {
     WaitForActiveFrames();
     
     // Wait for queues to ensure all semaphore operations complete
+    std::unique_lock<std::mutex> queueLock(m_queueSubmitMutex);
     VkResult presentResult = vkQueueWaitIdle(m_presentQueue);
     if (presentResult != VK_SUCCESS) {
         throw std::runtime_error("Failed to wait for present queue");
     }
     
     VkResult graphicsResult = vkQueueWaitIdle(m_graphicsQueue);
+    queueLock.unlock();
     if (graphicsResult != VK_SUCCESS) {
         throw std::runtime_error("Failed to wait for graphics queue");
     }
@@ -971,6 +1101,30 @@ void Renderer::BeginFrame() {
     // Mark frame as active and set its image index
     currentFrame.isActive = true;
     currentFrame.imageIndex = m_currentImageIndex;
+
+    // Submit uploads recorded by the loader threads, release staging resources
+    // of retired ones and publish models whose upload batch is done
+    if (m_gltfLoader && m_gltfLoader->GetTransferManager()) {
+        m_gltfLoader->GetTransferManager()->FlushSubmissions();
+        m_gltfLoader->GetTransferManager()->CollectCompleted();
+        m_gltfLoader->UpdatePendingUploads();
+        PublishCompletedLoads();
+        if (m_residencyManager) {
+            m_residencyManager->Update();
+        }
+        for (VertexFormat format : { VertexFormat::Float32, VertexFormat::Packed, VertexFormat::Skinned }) {
+            if (GeometryArena* geometryArena = m_gltfLoader->GetGeometryArena(format)) {
+                geometryArena->BeginFrame();
+            }
+        }
+        if (GeometryArena* morphArena = m_gltfLoader->GetMorphArena()) {
+            morphArena->BeginFrame();
+        }
+        m_gltfLoader->BeginFrame();
+        if (m_skinningSystem) {
+            m_skinningSystem->BeginFrame(m_currentFrame);
+        }
+    }
 }
 
 void Renderer::EndFrame() {
@@ -982,20 +1136,40 @@ void Renderer::EndFrame() {
     Frame& currentFrame = m_frames[m_currentFrame];
     ImageResources& imageRes = m_imageResources[m_currentImageIndex];
 
-    VkSemaphore waitSemaphores[] = { currentFrame.imageAvailableSemaphore };
+    std::vector<VkSemaphore> waitSemaphores = { currentFrame.imageAvailableSemaphore };
+    std::vector<VkPipelineStageFlags> waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    std::vector<uint64_t> waitValues = { 0 };
     VkSemaphore signalSemaphores[] = { imageRes.finishedSemaphore };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    uint64_t signalValues[] = { 0 };
+
+    // First use of freshly uploaded resources waits on their transfer tickets on the GPU
+    TransferManager* transferManager = m_gltfLoader ? m_gltfLoader->GetTransferManager() : nullptr;
+    if (transferManager && m_transferWaitValue > transferManager->GetCompletedValue()) {
+        waitSemaphores.push_back(transferManager->GetTimelineSemaphore());
+        waitStages.push_back(TransferManager::kAcquireStages);
+        waitValues.push_back(m_transferWaitValue);
+    }
+    m_transferWaitValue = 0;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &currentFrame.commandBuffer;
     submitInfo.signalSemaphoreCount = 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
+    std::unique_lock<std::mutex> queueLock(m_queueSubmitMutex);
     if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, currentFrame.inFlightFence) != VK_SUCCESS) {
         throw std::runtime_error("Failed to submit draw command buffer");
     }
@@ -1010,6 +1184,7 @@ void Renderer::EndFrame() {
     presentInfo.pImageIndices = &m_currentImageIndex;
 
     VkResult result = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+    queueLock.unlock();
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
         RecreateSwapchain();
@@ -1038,6 +1213,26 @@ void Renderer::Render() {
         throw std::runtime_error("Failed to begin recording command buffer");
     }
 
+    // Take ownership of buffers and images released by the transfer queue
+    TransferManager* transferManager = m_gltfLoader ? m_gltfLoader->GetTransferManager() : nullptr;
+    if (transferManager) {
+        m_transferWaitValue = std::max(m_transferWaitValue,
+                                       transferManager->RecordOwnershipAcquires(currentFrame.commandBuffer));
+        for (VertexFormat format : { VertexFormat::Float32, VertexFormat::Packed, VertexFormat::Skinned }) {
+            if (GeometryArena* geometryArena = m_gltfLoader->GetGeometryArena(format)) {
+                geometryArena->RecordCompaction(currentFrame.commandBuffer);
+            }
+        }
+        if (GeometryArena* morphArena = m_gltfLoader->GetMorphArena()) {
+            morphArena->RecordCompaction(currentFrame.commandBuffer);
+        }
+    }
+
+    // Skinned vertices are written before the render pass starts
+    if (m_skinningSystem) {
+        m_skinningSystem->RecordSkinning(currentFrame.commandBuffer, m_currentFrame);
+    }
+
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     renderPassInfo.renderPass = m_renderPass;
@@ -1086,7 +1281,7 @@ void Renderer::Render() {
     vkCmdBindVertexBuffers(currentFrame.commandBuffer, 0, 1, vertexBuffers, offsets);
     vkCmdDraw(currentFrame.commandBuffer, static_cast<uint32_t>(m_triangleVertices.size()), 1, 0, 0);
 
-    // Render loaded models (Phase 2)
+    // Render loaded models (Phase 2); they draw out of the geometry arenas
     if (m_gltfLoader) {
         // Try to render cube model if it's loaded - check multiple possible paths
         std::string modelPath = "assets/models/cube.glb";
@@ -1100,6 +1295,12 @@ void Renderer::Render() {
         RenderModel(modelPath);
     }
 
+    // Animated instances, already posed in world space
+    if (m_skinningSystem) {
+        vkCmdBindPipeline(currentFrame.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+        m_skinningSystem->RecordDraws(currentFrame.commandBuffer);
+    }
+
     vkCmdEndRenderPass(currentFrame.commandBuffer);
 
     if (vkEndCommandBuffer(currentFrame.commandBuffer) != VK_SUCCESS) {
@@ -1111,23 +1312,79 @@ void Renderer::OnWindowResize() {
     m_framebufferResized = true;
 }
 
-bool Renderer::LoadModel(const std::string& filepath) {
+ModelRequestId Renderer::RequestModel(const std::string& filepath) {
     if (!m_gltfLoader) {
         std::cerr << "glTF loader not initialized" << std::endl;
-        return false;
+        return 0;
     }
 
-    // Load model asynchronously
-    auto future = m_gltfLoader->LoadModelAsync(filepath);
-    auto result = future.get();
+    // Parsing and uploads run in the background; PublishCompletedLoads picks the result up
+    ModelRequestId request = m_gltfLoader->RequestModel(filepath);
+    m_modelRequests[request] = nullptr;
+    return request;
+}
 
-    if (!result.success) {
-        std::cerr << "Failed to load model: " << result.errorMessage << std::endl;
-        return false;
+ModelRequestStatus Renderer::GetModelRequestStatus(ModelRequestId request) const {
+    auto it = m_modelRequests.find(request);
+    if (it == m_modelRequests.end()) {
+        return ModelRequestStatus::Unknown;
     }
+    return it->second ? ModelRequestStatus::Ready : ModelRequestStatus::Pending;
+}
 
-    std::cout << "Model loaded successfully: " << filepath << std::endl;
-    return true;
+void Renderer::ReleaseModel(ModelRequestId request) {
+    auto it = m_modelRequests.find(request);
+    if (it != m_modelRequests.end() && it->second) {
+        m_modelRequests.erase(it);
+    }
+}
+
+void Renderer::PublishCompletedLoads() {
+    m_gltfLoader->DrainCompletedLoads(m_completedLoads);
+
+    // Finished loads join the scene once their uploads have retired; until
+    // then they stay queued here
+    auto it = m_completedLoads.begin();
+    while (it != m_completedLoads.end()) {
+        const AssetLoadResult& result = it->result;
+        if (!result.success) {
+            std::cerr << "Failed to load model: " << result.errorMessage << std::endl;
+            m_modelRequests.erase(it->request);
+        } else if (result.model->isLoaded) {
+            m_modelRequests[it->request] = result.model;
+            std::cout << "Model loaded successfully: " << it->filepath << std::endl;
+        } else {
+            ++it;
+            continue;
+        }
+        it = m_completedLoads.erase(it);
+    }
+}
+
+AnimatedInstanceId Renderer::CreateAnimatedInstance(const std::string& modelName, const glm::mat4& transform,
+                                                    uint32_t clip) {
+    if (!m_gltfLoader || !m_skinningSystem) {
+        return 0;
+    }
+
+    auto model = m_gltfLoader->GetModel(modelName);
+    if (!model) {
+        std::cerr << "Cannot animate " << modelName << ": model not loaded" << std::endl;
+        return 0;
+    }
+    return m_skinningSystem->CreateInstance(model, transform, clip);
+}
+
+void Renderer::DestroyAnimatedInstance(AnimatedInstanceId id) {
+    if (m_skinningSystem) {
+        m_skinningSystem->DestroyInstance(id);
+    }
+}
+
+void Renderer::UpdateAnimations(float deltaTime) {
+    if (m_skinningSystem) {
+        m_skinningSystem->Update(deltaTime);
+    }
 }
 
 bool Renderer::CreateCubeModel() {
@@ -1142,6 +1399,7 @@ bool Renderer::CreateCubeModel() {
         return false;
     }
 
+    m_modelHandles.push_back(result.model);
     std::cout << "Cube model created successfully" << std::endl;
     return true;
 }
@@ -1152,28 +1410,57 @@ void Renderer::RenderModel(const std::string& modelName) {
     }
 
     auto model = m_gltfLoader->GetModel(modelName);
-    if (!model || !model->isLoaded) {
+    if (!model) {
+        return;
+    }
+
+    // Evicted models are reloaded in the background and draw again once back
+    if (m_residencyManager && !m_residencyManager->RequestResident(modelName)) {
+        return;
+    }
+
+    // Models only become loaded once their upload batch has retired
+    if (!model->isLoaded) {
         return;
     }
 
     Frame& currentFrame = m_frames[m_currentFrame];
     
-    // Render each mesh in the model
-    for (const auto& mesh : model->meshes) {
-        if (mesh.vertexBuffer == VK_NULL_HANDLE || mesh.indexBuffer == VK_NULL_HANDLE) {
+    // One pass per vertex format, each with its pipeline and arena bound once;
+    // each submesh only needs its offsets within its mesh's range
+    for (VertexFormat format : { VertexFormat::Float32, VertexFormat::Packed }) {
+        GeometryArena* geometryArena = m_gltfLoader->GetGeometryArena(format);
+        if (!geometryArena) {
             continue;
         }
 
-        // Bind vertex buffer
-        VkBuffer vertexBuffers[] = { mesh.vertexBuffer };
-        VkDeviceSize offsets[] = { 0 };
-        vkCmdBindVertexBuffers(currentFrame.commandBuffer, 0, 1, vertexBuffers, offsets);
+        bool bound = false;
+        for (const auto& mesh : model->meshes) {
+            GeometryRange range;
+            if (mesh.vertexFormat != format || !geometryArena->GetRange(mesh.geometry, range)) {
+                continue;
+            }
+
+            if (!bound) {
+                vkCmdBindPipeline(currentFrame.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                  format == VertexFormat::Packed ? m_packedGraphicsPipeline : m_graphicsPipeline);
+                geometryArena->Bind(currentFrame.commandBuffer);
+                bound = true;
+            }
 
-        // Bind index buffer
-        vkCmdBindIndexBuffer(currentFrame.commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            if (format == VertexFormat::Packed) {
+                PackedMeshConstants constants{};
+                constants.positionOffset = glm::vec4(mesh.positionOffset, 0.0f);
+                constants.positionScale = glm::vec4(mesh.positionScale, 0.0f);
+                vkCmdPushConstants(currentFrame.commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                   sizeof(constants), &constants);
+            }
 
-        // Draw indexed
-        vkCmdDrawIndexed(currentFrame.commandBuffer, static_cast<uint32_t>(mesh.indices.size()), 1, 0, 0, 0);
+            for (const auto& submesh : mesh.submeshes) {
+                vkCmdDrawIndexed(currentFrame.commandBuffer, submesh.indexCount, 1,
+                                 range.firstIndex + submesh.firstIndex, range.vertexOffset + submesh.vertexOffset, 0);
+            }
+        }
     }
 }
 
@@ -0,0 +1,132 @@
+#include "core/residency_manager.hpp"
+#include "assets/gltf_loader.hpp"
+#include <json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace aero_boar {
+
+ResidencyConfig ResidencyConfig::LoadFromFile(const std::string& filepath) {
+    ResidencyConfig config;
+
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cout << "Residency config not found at " << filepath << ", using defaults" << std::endl;
+        return config;
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        if (json.contains("budgetFraction")) {
+            config.budgetFraction = json["budgetFraction"].get<float>();
+        }
+        if (json.contains("minIdleFrames")) {
+            config.minIdleFrames = json["minIdleFrames"].get<uint32_t>();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to parse residency config " << filepath << ": " << e.what() << std::endl;
+    }
+
+    return config;
+}
+
+ResidencyManager::ResidencyManager(VmaAllocator allocator, GltfLoader& loader, uint32_t framesInFlight,
+                                   const ResidencyConfig& config)
+    : m_allocator(allocator), m_loader(loader), m_config(config), m_framesInFlight(framesInFlight) {
+}
+
+void ResidencyManager::Update() {
+    // Also makes VMA refresh its budget from VK_EXT_memory_budget
+    m_frameIndex++;
+    vmaSetCurrentFrameIndex(m_allocator, m_frameIndex);
+
+    const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+    vmaGetMemoryProperties(m_allocator, &memoryProperties);
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(m_allocator, budgets);
+
+    // On unified memory (Quest) the single heap is device-local
+    m_stats = ResidencyStats{};
+    for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++) {
+        if (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            m_stats.heapUsage += budgets[i].usage;
+            m_stats.heapBudget += budgets[i].budget;
+        }
+    }
+    // Textures already evicted still hold memory until their frames retire;
+    // counting them would evict again for memory that is on its way out
+    VkDeviceSize retiredBytes = m_loader.GetRetiredTextureBytes();
+    m_stats.heapUsage -= std::min(m_stats.heapUsage, retiredBytes);
+    m_stats.modelBytes = m_loader.GetResidentBytes();
+    std::vector<ModelResidency> models = m_loader.GetResidentModels();
+    for (const auto& model : models) {
+        m_stats.textureBytes += model.textureBytes;
+    }
+
+    VkDeviceSize limit = static_cast<VkDeviceSize>(static_cast<double>(m_stats.heapBudget) * m_config.budgetFraction);
+    if (m_stats.heapUsage <= limit) {
+        m_reportedUnreachable = false;
+        return;
+    }
+
+    // Arenas, staging and render targets stay whatever is evicted; when they
+    // alone exceed the limit, evicting would only make models reload
+    VkDeviceSize fixedUsage = m_stats.heapUsage - std::min(m_stats.heapUsage, m_stats.textureBytes);
+    if (fixedUsage >= limit) {
+        if (!m_reportedUnreachable) {
+            std::cerr << "Device-local usage outside model textures (" << fixedUsage / (1024 * 1024)
+                      << " MB) exceeds the residency limit (" << limit / (1024 * 1024)
+                      << " MB); not evicting" << std::endl;
+            m_reportedUnreachable = true;
+        }
+        return;
+    }
+    m_reportedUnreachable = false;
+
+    // Models never rendered count as rendered when first seen here, so a
+    // fresh load gets the same grace period as a drawn model
+    struct Candidate {
+        uint32_t lastRenderedFrame;
+        ModelResidency model;
+    };
+    uint32_t minIdleFrames = std::max(m_config.minIdleFrames, m_framesInFlight);
+    std::vector<Candidate> candidates;
+    for (auto& model : models) {
+        auto [it, inserted] = m_lastRenderedFrame.try_emplace(model.name, m_frameIndex);
+        if (model.textureBytes > 0 && m_frameIndex - it->second >= minIdleFrames) {
+            candidates.push_back(Candidate{ it->second, std::move(model) });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastRenderedFrame < b.lastRenderedFrame;
+    });
+
+    // Evicting stops once the freed textures cover the excess
+    VkDeviceSize excess = m_stats.heapUsage - limit;
+    for (const auto& candidate : candidates) {
+        if (excess == 0) {
+            break;
+        }
+        if (m_loader.EvictModel(candidate.model.name)) {
+            std::cout << "Evicted model " << candidate.model.name << " (" << candidate.model.bytes / 1024
+                      << " KB, idle " << m_frameIndex - candidate.lastRenderedFrame << " frames)" << std::endl;
+            excess -= std::min(excess, candidate.model.textureBytes);
+            m_stats.modelBytes -= std::min(m_stats.modelBytes, candidate.model.bytes);
+            m_stats.textureBytes -= std::min(m_stats.textureBytes, candidate.model.textureBytes);
+            m_stats.evictedThisFrame++;
+        }
+    }
+}
+
+bool ResidencyManager::RequestResident(const std::string& name) {
+    m_lastRenderedFrame[name] = m_frameIndex;
+    if (m_loader.IsModelEvicted(name)) {
+        m_loader.ReloadModel(name);
+        return false;
+    }
+    return true;
+}
+
+} // namespace aero_boar
@@ -0,0 +1,634 @@
+#include "core/skinning_system.hpp"
+#include "core/geometry_arena.hpp"
+#include "core/residency_manager.hpp"
+#include "assets/gltf_loader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace aero_boar {
+
+namespace {
+
+constexpr uint32_t kWorkgroupSize = 64;    // local_size_x in skinning.comp
+constexpr size_t kInstancesPerTask = 4;    // Enough work per task to amortize scheduling
+constexpr uint32_t kStorageBufferCount = 7; // Source vertices, palettes, jobs, output, morph offsets, deltas, weights
+constexpr uint32_t kNoMorphTargets = 0xFFFFFFFFu; // Matches skinning.comp
+constexpr size_t kMaxActiveMorphTargets = 8;      // Strongest weights blended per mesh; the rest count as zero
+
+// Zeroes all but the kMaxActiveMorphTargets weights of largest magnitude, so
+// a face rig with dozens of targets costs the shader a bounded amount
+void LimitActiveMorphTargets(float* weights, size_t count) {
+    if (count <= kMaxActiveMorphTargets) {
+        return;
+    }
+
+    thread_local std::vector<float> magnitudes;
+    magnitudes.resize(count);
+    for (size_t t = 0; t < count; t++) {
+        magnitudes[t] = std::abs(weights[t]);
+    }
+    std::nth_element(magnitudes.begin(), magnitudes.begin() + (kMaxActiveMorphTargets - 1), magnitudes.end(),
+                     std::greater<float>());
+    float threshold = magnitudes[kMaxActiveMorphTargets - 1];
+
+    // Weights above the threshold always stay; ties fill what is left
+    size_t kept = 0;
+    for (size_t t = 0; t < count; t++) {
+        kept += std::abs(weights[t]) > threshold ? 1 : 0;
+    }
+    for (size_t t = 0; t < count; t++) {
+        float magnitude = std::abs(weights[t]);
+        if (magnitude > threshold) {
+            continue;
+        }
+        if (magnitude == threshold && kept < kMaxActiveMorphTargets) {
+            kept++;
+        } else {
+            weights[t] = 0.0f;
+        }
+    }
+}
+
+struct PushConstants {
+    uint32_t jobCount;
+    uint32_t threadCount;
+};
+
+} // namespace
+
+SkinningSystem::SkinningSystem(VkDevice device, VmaAllocator allocator, GltfLoader& loader,
+                               ResidencyManager* residencyManager, uint32_t framesInFlight)
+    : m_device(device), m_allocator(allocator), m_loader(loader), m_residencyManager(residencyManager),
+      m_framesInFlight(framesInFlight) {
+}
+
+SkinningSystem::~SkinningSystem() {
+    Shutdown();
+}
+
+bool SkinningSystem::Initialize(const std::vector<char>& computeShaderCode) {
+    try {
+        if (!CreatePipeline(computeShaderCode)) {
+            std::cerr << "Failed to create skinning pipeline" << std::endl;
+            return false;
+        }
+
+        m_frames.resize(m_framesInFlight);
+        std::vector<VkDescriptorSetLayout> layouts(m_framesInFlight, m_descriptorSetLayout);
+        std::vector<VkDescriptorSet> sets(m_framesInFlight);
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_descriptorPool;
+        allocInfo.descriptorSetCount = m_framesInFlight;
+        allocInfo.pSetLayouts = layouts.data();
+        if (vkAllocateDescriptorSets(m_device, &allocInfo, sets.data()) != VK_SUCCESS) {
+            std::cerr << "Failed to allocate skinning descriptor sets" << std::endl;
+            return false;
+        }
+        for (uint32_t i = 0; i < m_framesInFlight; i++) {
+            m_frames[i].descriptorSet = sets[i];
+        }
+
+        // Leave the other cores to the loader's pool and the render thread
+        m_threadPool = std::make_unique<AssetThreadPool>(std::max(1u, std::thread::hardware_concurrency() / 2));
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "SkinningSystem initialization failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void SkinningSystem::Shutdown() {
+    WaitForEvaluation();
+    if (m_threadPool) {
+        m_threadPool->Shutdown();
+        m_threadPool.reset();
+    }
+    m_evaluations.clear();
+    m_instances.clear();
+    m_freeIds.clear();
+    m_jobs.clear();
+    m_draws.clear();
+
+    for (auto& frame : m_frames) {
+        DestroyHostBuffer(frame.palettes);
+        DestroyHostBuffer(frame.morphWeights);
+        DestroyHostBuffer(frame.jobs);
+    }
+    m_frames.clear();
+
+    for (auto& retired : m_retiredBuffers) {
+        vmaDestroyBuffer(m_allocator, retired.buffer, retired.allocation);
+    }
+    m_retiredBuffers.clear();
+    if (m_outputBuffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(m_allocator, m_outputBuffer, m_outputAllocation);
+        m_outputBuffer = VK_NULL_HANDLE;
+        m_outputAllocation = VK_NULL_HANDLE;
+        m_outputCapacity = 0;
+    }
+
+    if (m_pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        m_pipeline = VK_NULL_HANDLE;
+    }
+    if (m_pipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+        m_pipelineLayout = VK_NULL_HANDLE;
+    }
+    if (m_descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+        m_descriptorPool = VK_NULL_HANDLE;
+    }
+    if (m_descriptorSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
+        m_descriptorSetLayout = VK_NULL_HANDLE;
+    }
+}
+
+bool SkinningSystem::CreatePipeline(const std::vector<char>& computeShaderCode) {
+    VkDescriptorSetLayoutBinding bindings[kStorageBufferCount]{};
+    for (uint32_t i = 0; i < kStorageBufferCount; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = kStorageBufferCount;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = kStorageBufferCount * m_framesInFlight;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = m_framesInFlight;
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = computeShaderCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(computeShaderCode.data());
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(m_device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout;
+    VkResult result = vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+    vkDestroyShaderModule(m_device, shaderModule, nullptr);
+    return result == VK_SUCCESS;
+}
+
+AnimatedInstanceId SkinningSystem::CreateInstance(std::shared_ptr<Model> model, const glm::mat4& transform,
+                                                  uint32_t clip) {
+    if (!model) {
+        return kInvalidAnimatedInstance;
+    }
+
+    AnimatedInstanceId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        m_instances.emplace_back();
+        id = static_cast<AnimatedInstanceId>(m_instances.size());
+    }
+
+    Instance& instance = m_instances[id - 1];
+    instance.model = std::move(model);
+    instance.transform = transform;
+    instance.clip = clip;
+    instance.time = 0.0f;
+    return id;
+}
+
+void SkinningSystem::DestroyInstance(AnimatedInstanceId id) {
+    if (id == kInvalidAnimatedInstance || id > m_instances.size() || !m_instances[id - 1].model) {
+        return;
+    }
+    m_instances[id - 1] = Instance{};
+    m_freeIds.push_back(id);
+}
+
+void SkinningSystem::SetTransform(AnimatedInstanceId id, const glm::mat4& transform) {
+    if (id != kInvalidAnimatedInstance && id <= m_instances.size() && m_instances[id - 1].model) {
+        m_instances[id - 1].transform = transform;
+    }
+}
+
+void SkinningSystem::Update(float deltaTime) {
+    for (auto& instance : m_instances) {
+        if (!instance.model) {
+            continue;
+        }
+
+        // Wrapped here rather than at sampling so long sessions keep precision
+        instance.time += deltaTime;
+        const auto& animations = instance.model->animations;
+        if (instance.clip < animations.size() && animations[instance.clip].duration > 0.0f) {
+            instance.time = std::fmod(instance.time, animations[instance.clip].duration);
+        }
+    }
+}
+
+void SkinningSystem::BeginFrame(uint32_t frameIndex) {
+    WaitForEvaluation();
+
+    // Output buffers replaced by a larger one, once no frame can draw from them
+    auto retired = m_retiredBuffers.begin();
+    while (retired != m_retiredBuffers.end()) {
+        if (retired->framesLeft == 0) {
+            vmaDestroyBuffer(m_allocator, retired->buffer, retired->allocation);
+            retired = m_retiredBuffers.erase(retired);
+        } else {
+            retired->framesLeft--;
+            ++retired;
+        }
+    }
+
+    // Snapshot the instances whose models can draw, and lay their palettes and
+    // morph weights out back to back; evicted models are reloaded and join a
+    // later frame
+    m_evaluations.clear();
+    m_residentModels.clear();
+    uint32_t jointCount = 0;
+    uint32_t morphWeightCount = 0;
+    for (const auto& instance : m_instances) {
+        const Model* model = instance.model.get();
+        if (!model) {
+            continue;
+        }
+
+        auto resident = m_residentModels.find(model);
+        if (resident == m_residentModels.end()) {
+            bool drawable = (!m_residencyManager || m_residencyManager->RequestResident(model->name)) &&
+                            model->isLoaded && !model->skinBindings.empty();
+            resident = m_residentModels.emplace(model, drawable).first;
+        }
+        if (!resident->second) {
+            continue;
+        }
+
+        Evaluation evaluation;
+        evaluation.model = instance.model;
+        evaluation.transform = instance.transform;
+        evaluation.clip = instance.clip;
+        evaluation.time = instance.time;
+        evaluation.firstJoint = jointCount;
+        evaluation.firstMorphWeight = morphWeightCount;
+        for (const auto& skin : model->skins) {
+            jointCount += static_cast<uint32_t>(skin.joints.size());
+        }
+        for (const auto& binding : model->skinBindings) {
+            if (binding.mesh < model->meshes.size()) {
+                morphWeightCount += model->meshes[binding.mesh].morphTargetCount;
+            }
+        }
+        m_evaluations.push_back(std::move(evaluation));
+    }
+
+    if (m_evaluations.empty()) {
+        return;
+    }
+
+    FrameResources& frame = m_frames[frameIndex];
+    if (!ReserveHostBuffer(frame.palettes, std::max<VkDeviceSize>(jointCount, 1) * sizeof(glm::mat4),
+                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) ||
+        !ReserveHostBuffer(frame.morphWeights, std::max<VkDeviceSize>(morphWeightCount, 1) * sizeof(float),
+                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+        std::cerr << "Failed to allocate joint palettes for " << jointCount << " joints and "
+                  << morphWeightCount << " morph weights" << std::endl;
+        m_evaluations.clear();
+        return;
+    }
+
+    // The palettes and weights are needed once the frame records its dispatch;
+    // until then they are evaluated alongside the rest of the frame's setup
+    glm::mat4* palettes = static_cast<glm::mat4*>(frame.palettes.mapped);
+    float* morphWeights = static_cast<float*>(frame.morphWeights.mapped);
+    m_evaluationTasks = std::make_unique<AssetTaskGroup>(m_threadPool.get());
+    for (size_t first = 0; first < m_evaluations.size(); first += kInstancesPerTask) {
+        size_t count = std::min(kInstancesPerTask, m_evaluations.size() - first);
+        m_evaluationTasks->Run([this, first, count, palettes, morphWeights]() {
+            EvaluateInstances(first, count, palettes, morphWeights);
+        });
+    }
+}
+
+void SkinningSystem::EvaluateInstances(size_t first, size_t count, glm::mat4* palettes, float* morphWeights) const {
+    // Scratch space reused across frames by each worker thread
+    thread_local std::vector<NodePose> poses;
+    thread_local std::vector<glm::mat4> transforms;
+    thread_local std::vector<float> nodeWeights;
+    thread_local std::vector<float> meshWeights;
+
+    for (size_t i = first; i < first + count; i++) {
+        const Evaluation& evaluation = m_evaluations[i];
+        const Model& model = *evaluation.model;
+        const Skeleton& skeleton = model.skeleton;
+
+        poses.assign(skeleton.restPoses.begin(), skeleton.restPoses.end());
+        nodeWeights.assign(skeleton.restMorphWeights.begin(), skeleton.restMorphWeights.end());
+        if (evaluation.clip < model.animations.size()) {
+            SampleAnimationClip(model.animations[evaluation.clip], evaluation.time, poses.data(),
+                                nodeWeights.data());
+        }
+        transforms.resize(poses.size());
+        ComputeNodeTransforms(model.skeleton, poses.data(), transforms.data());
+
+        // The instance transform is folded in, so skinned vertices come out in
+        // world space and draw with an identity model matrix
+        glm::mat4* palette = palettes + evaluation.firstJoint;
+        for (const auto& skin : model.skins) {
+            for (size_t j = 0; j < skin.joints.size(); j++) {
+                *palette++ = evaluation.transform * transforms[skin.joints[j]] * skin.inverseBindMatrices[j];
+            }
+        }
+
+        // Each skinned mesh takes its node's weights, in the order BeginFrame
+        // counted them; the mapped memory is written once, sequentially
+        uint32_t morphWeight = evaluation.firstMorphWeight;
+        for (const auto& binding : model.skinBindings) {
+            if (binding.mesh >= model.meshes.size()) {
+                continue;
+            }
+            uint32_t targetCount = model.meshes[binding.mesh].morphTargetCount;
+            if (targetCount == 0) {
+                continue;
+            }
+
+            size_t available = 0;
+            const float* weights = nullptr;
+            if (binding.node + 1 < skeleton.firstMorphWeights.size()) {
+                available = skeleton.firstMorphWeights[binding.node + 1] - skeleton.firstMorphWeights[binding.node];
+                weights = nodeWeights.data() + skeleton.firstMorphWeights[binding.node];
+            }
+            meshWeights.assign(targetCount, 0.0f);
+            std::copy(weights, weights + std::min<size_t>(available, targetCount), meshWeights.begin());
+            LimitActiveMorphTargets(meshWeights.data(), meshWeights.size());
+            memcpy(morphWeights + morphWeight, meshWeights.data(), targetCount * sizeof(float));
+            morphWeight += targetCount;
+        }
+    }
+}
+
+void SkinningSystem::WaitForEvaluation() {
+    if (!m_evaluationTasks) {
+        return;
+    }
+
+    try {
+        m_evaluationTasks->Wait();
+    } catch (const std::exception& e) {
+        std::cerr << "Joint palette evaluation failed: " << e.what() << std::endl;
+        m_evaluations.clear();
+    }
+    m_evaluationTasks.reset();
+}
+
+void SkinningSystem::RecordSkinning(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    WaitForEvaluation();
+    m_jobs.clear();
+    m_draws.clear();
+
+    GeometryArena* geometryArena = m_loader.GetGeometryArena(VertexFormat::Skinned);
+    GeometryArena* morphArena = m_loader.GetMorphArena();
+    if (m_evaluations.empty() || !geometryArena || !morphArena) {
+        return;
+    }
+
+    // One job per skinned mesh of each instance, one thread per vertex. Ranges
+    // are read here because compaction may have just moved them.
+    uint32_t threadCount = 0;
+    for (const auto& evaluation : m_evaluations) {
+        const Model& model = *evaluation.model;
+        uint32_t morphWeight = evaluation.firstMorphWeight;
+        for (const auto& binding : model.skinBindings) {
+            if (binding.mesh >= model.meshes.size()) {
+                continue;
+            }
+            const Mesh& mesh = model.meshes[binding.mesh];
+            uint32_t firstMorphWeight = morphWeight;
+            morphWeight += mesh.morphTargetCount;
+            if (binding.skin >= model.skins.size()) {
+                continue;
+            }
+
+            GeometryRange range;
+            if (mesh.vertexFormat != VertexFormat::Skinned ||
+                mesh.jointCount > model.skins[binding.skin].joints.size() ||
+                !geometryArena->GetRange(mesh.geometry, range) || range.vertexCount == 0) {
+                continue;
+            }
+
+            uint32_t skinOffset = 0;
+            for (uint32_t s = 0; s < binding.skin; s++) {
+                skinOffset += static_cast<uint32_t>(model.skins[s].joints.size());
+            }
+
+            SkinningJob job;
+            job.sourceVertex = static_cast<uint32_t>(range.vertexOffset);
+            job.firstJoint = evaluation.firstJoint + skinOffset;
+            job.firstThread = threadCount;
+            job.morphOffsets = kNoMorphTargets;
+            GeometryRange morphRange;
+            if (mesh.morphTargetCount > 0 && morphArena->GetRange(mesh.morphGeometry, morphRange)) {
+                job.morphOffsets = morphRange.firstIndex;
+                job.morphDeltas = static_cast<uint32_t>(morphRange.vertexOffset);
+                job.firstMorphWeight = firstMorphWeight;
+            }
+            m_jobs.push_back(job);
+
+            for (const auto& submesh : mesh.submeshes) {
+                DrawCommand draw;
+                draw.indexCount = submesh.indexCount;
+                draw.firstIndex = range.firstIndex + submesh.firstIndex;
+                draw.vertexOffset = static_cast<int32_t>(threadCount) + submesh.vertexOffset;
+                m_draws.push_back(draw);
+            }
+            threadCount += range.vertexCount;
+        }
+    }
+
+    if (m_jobs.empty()) {
+        return;
+    }
+
+    FrameResources& frame = m_frames[frameIndex];
+    if (!ReserveOutput(threadCount) ||
+        !ReserveHostBuffer(frame.jobs, m_jobs.size() * sizeof(SkinningJob), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+        std::cerr << "Failed to allocate skinning buffers for " << threadCount << " vertices" << std::endl;
+        m_draws.clear();
+        return;
+    }
+    memcpy(frame.jobs.mapped, m_jobs.data(), m_jobs.size() * sizeof(SkinningJob));
+    vmaFlushAllocation(m_allocator, frame.jobs.allocation, 0, VK_WHOLE_SIZE);
+    vmaFlushAllocation(m_allocator, frame.palettes.allocation, 0, VK_WHOLE_SIZE);
+    vmaFlushAllocation(m_allocator, frame.morphWeights.allocation, 0, VK_WHOLE_SIZE);
+
+    VkDescriptorBufferInfo bufferInfos[kStorageBufferCount] = {
+        { geometryArena->GetVertexBuffer(), 0, VK_WHOLE_SIZE },
+        { frame.palettes.buffer, 0, VK_WHOLE_SIZE },
+        { frame.jobs.buffer, 0, VK_WHOLE_SIZE },
+        { m_outputBuffer, 0, VK_WHOLE_SIZE },
+        { morphArena->GetIndexBuffer(), 0, VK_WHOLE_SIZE },
+        { morphArena->GetVertexBuffer(), 0, VK_WHOLE_SIZE },
+        { frame.morphWeights.buffer, 0, VK_WHOLE_SIZE },
+    };
+    VkWriteDescriptorSet writes[kStorageBufferCount]{};
+    for (uint32_t i = 0; i < kStorageBufferCount; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = frame.descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_device, kStorageBufferCount, writes, 0, nullptr);
+
+    // Compaction may have just copied the sources, and the previous frame may
+    // still be drawing from the output
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    PushConstants constants{ static_cast<uint32_t>(m_jobs.size()), threadCount };
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                            &frame.descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants),
+                       &constants);
+    vkCmdDispatch(commandBuffer, (threadCount + kWorkgroupSize - 1) / kWorkgroupSize, 1, 1);
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void SkinningSystem::RecordDraws(VkCommandBuffer commandBuffer) const {
+    GeometryArena* geometryArena = m_loader.GetGeometryArena(VertexFormat::Skinned);
+    if (m_draws.empty() || !geometryArena) {
+        return;
+    }
+
+    // Posed vertices keep their meshes' order, so the arena's indices apply
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_outputBuffer, &offset);
+    geometryArena->BindIndexBuffer(commandBuffer);
+    for (const auto& draw : m_draws) {
+        vkCmdDrawIndexed(commandBuffer, draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+    }
+}
+
+bool SkinningSystem::ReserveHostBuffer(HostBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (buffer.size >= size) {
+        return true;
+    }
+
+    // Grown geometrically; the frame's fence has already retired the old one
+    VkDeviceSize capacity = std::max(size, buffer.size * 2);
+    DestroyHostBuffer(buffer);
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo allocationInfo{};
+    if (vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo, &buffer.buffer, &buffer.allocation,
+                        &allocationInfo) != VK_SUCCESS) {
+        buffer = HostBuffer{};
+        return false;
+    }
+    buffer.mapped = allocationInfo.pMappedData;
+    buffer.size = capacity;
+    return true;
+}
+
+bool SkinningSystem::ReserveOutput(uint64_t vertexCount) {
+    if (m_outputCapacity >= vertexCount) {
+        return true;
+    }
+
+    // Frames in flight may still draw from the old buffer
+    if (m_outputBuffer != VK_NULL_HANDLE) {
+        m_retiredBuffers.push_back({ m_outputBuffer, m_outputAllocation, m_framesInFlight });
+        m_outputBuffer = VK_NULL_HANDLE;
+        m_outputAllocation = VK_NULL_HANDLE;
+    }
+
+    uint64_t capacity = std::max(vertexCount, m_outputCapacity * 2);
+    m_outputCapacity = 0;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity * sizeof(Vertex);
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    if (vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo, &m_outputBuffer, &m_outputAllocation,
+                        nullptr) != VK_SUCCESS) {
+        m_outputBuffer = VK_NULL_HANDLE;
+        m_outputAllocation = VK_NULL_HANDLE;
+        return false;
+    }
+    m_outputCapacity = capacity;
+    return true;
+}
+
+void SkinningSystem::DestroyHostBuffer(HostBuffer& buffer) {
+    if (buffer.buffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(m_allocator, buffer.buffer, buffer.allocation);
+    }
+    buffer = HostBuffer{};
+}
+
+} // namespace aero_boar
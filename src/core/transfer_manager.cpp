@@ -1,12 +1,95 @@
 #include "core/transfer_manager.hpp"
+#include <json.hpp>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace aero_boar {
 
-TransferManager::TransferManager(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator)
-    : m_device(device), m_physicalDevice(physicalDevice), m_allocator(allocator) {
+namespace {
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Distinguishes managers in the per-thread context caches
+std::atomic<uint64_t> g_nextInstanceId{1};
+
+} // namespace
+
+TransferConfig TransferConfig::LoadFromFile(const std::string& filepath) {
+    TransferConfig config;
+
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cout << "Transfer config not found at " << filepath << ", using defaults" << std::endl;
+        return config;
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        if (json.contains("stagingRingSizeMB")) {
+            config.stagingRingSize = json["stagingRingSizeMB"].get<VkDeviceSize>() * 1024 * 1024;
+        }
+        if (json.contains("frameUploadBudgetMB")) {
+            config.frameUploadBudget = json["frameUploadBudgetMB"].get<VkDeviceSize>() * 1024 * 1024;
+        }
+        if (json.contains("statsIntervalSeconds")) {
+            config.statsIntervalSeconds = json["statsIntervalSeconds"].get<float>();
+        }
+        if (json.contains("statsCsvPath")) {
+            config.statsCsvPath = json["statsCsvPath"].get<std::string>();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to parse transfer config " << filepath << ": " << e.what() << std::endl;
+    }
+
+    return config;
+}
+
+size_t TransferStats::GetLatencyBucket(double milliseconds) {
+    for (size_t i = 0; i < kLatencyBuckets - 1; i++) {
+        if (milliseconds <= kLatencyBucketLimitsMs[i]) {
+            return i;
+        }
+    }
+    return kLatencyBuckets - 1;
+}
+
+void TransferBatch::AddBufferCopy(VkBuffer buffer, VmaAllocation allocation, const void* data, size_t dataSize,
+                                  VkDeviceSize dstOffset) {
+    BufferCopy copy;
+    copy.buffer = buffer;
+    copy.allocation = allocation;
+    copy.data = data;
+    copy.size = dataSize;
+    copy.dstOffset = dstOffset;
+    m_bufferCopies.push_back(copy);
+}
+
+void TransferBatch::AddImageCopy(VkImage image, const VkImageCreateInfo& imageInfo, const void* data,
+                                 size_t dataSize, const std::vector<VkDeviceSize>& levelOffsets, bool generateMips) {
+    ImageCopy copy;
+    copy.image = image;
+    copy.extent = imageInfo.extent;
+    copy.mipLevels = imageInfo.mipLevels;
+    copy.arrayLayers = imageInfo.arrayLayers;
+    copy.data = data;
+    copy.size = dataSize;
+    copy.levelOffsets = levelOffsets.empty() ? std::vector<VkDeviceSize>{0} : levelOffsets;
+    copy.generateMips = generateMips;
+    m_imageCopies.push_back(std::move(copy));
+}
+
+TransferManager::TransferManager(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator,
+                                 const TransferQueueInfo& queueInfo, const TransferConfig& config)
+    : m_device(device), m_physicalDevice(physicalDevice), m_allocator(allocator), m_config(config),
+      m_queueInfo(queueInfo), m_instanceId(g_nextInstanceId++),
+      m_graphicsQueueFamilyIndex(queueInfo.graphicsFamilyIndex) {
 }
 
 TransferManager::~TransferManager() {
@@ -20,19 +103,31 @@ bool TransferManager::Initialize() {
             return false;
         }
 
-        if (!CreateCommandPool()) {
-            std::cerr << "Failed to create command pool" << std::endl;
+        if (!CreateTimelineSemaphore()) {
+            std::cerr << "Failed to create timeline semaphore" << std::endl;
             return false;
         }
 
-        if (!CreateCommandBuffer()) {
-            std::cerr << "Failed to create command buffer" << std::endl;
+        if (!CreateStagingRing()) {
+            std::cerr << "Failed to create staging ring" << std::endl;
             return false;
         }
 
-        if (!CreateFence()) {
-            std::cerr << "Failed to create fence" << std::endl;
-            return false;
+        DetectUnifiedMemory();
+        CreateTimestampQueries();
+
+        m_stats.stagingSize = m_stagingSize;
+        m_windowStart = std::chrono::steady_clock::now();
+        m_lastStatsOutput = m_windowStart;
+        if (m_config.statsIntervalSeconds > 0.0f && !m_config.statsCsvPath.empty()) {
+            m_statsCsv.open(m_config.statsCsvPath, std::ios::out | std::ios::trunc);
+            if (m_statsCsv.is_open()) {
+                m_statsCsv << "seconds,total_bytes,total_batches,frame_bytes,bytes_per_second,queued_batches,"
+                              "in_flight_batches,staging_used,staging_high_water,max_submit_latency_ms,"
+                              "max_gpu_time_ms,wait_stall_ms,staging_stall_ms\n";
+            } else {
+                std::cerr << "Failed to open transfer stats file " << m_config.statsCsvPath << std::endl;
+            }
         }
 
         std::cout << "Transfer manager initialized successfully" << std::endl;
@@ -44,127 +139,274 @@ bool TransferManager::Initialize() {
 }
 
 void TransferManager::Shutdown() {
-    if (m_fence != VK_NULL_HANDLE) {
-        vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, UINT64_MAX);
-        vkDestroyFence(m_device, m_fence, nullptr);
-        m_fence = VK_NULL_HANDLE;
+    if (m_timelineSemaphore != VK_NULL_HANDLE) {
+        // Submit whatever is still queued and let every upload retire before
+        // releasing its resources. Recording threads must be stopped by now.
+        SubmitQueued(UINT64_MAX, 0, nullptr);
+
+        uint64_t lastSubmittedValue = m_lastSubmittedValue.load();
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_timelineSemaphore;
+        waitInfo.pValues = &lastSubmittedValue;
+        vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX);
+
+        CollectCompleted();
+
+        vkDestroySemaphore(m_device, m_timelineSemaphore, nullptr);
+        m_timelineSemaphore = VK_NULL_HANDLE;
+    }
+
+    if (m_timestampPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_device, m_timestampPool, nullptr);
+        m_timestampPool = VK_NULL_HANDLE;
+        m_freeTimestampSlots.clear();
+    }
+
+    if (m_statsCsv.is_open()) {
+        m_statsCsv.close();
     }
 
-    if (m_commandPool != VK_NULL_HANDLE) {
-        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
-        m_commandPool = VK_NULL_HANDLE;
+    if (m_stagingBuffer != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(m_allocator, m_stagingBuffer, m_stagingAllocation);
+        m_stagingBuffer = VK_NULL_HANDLE;
+        m_stagingAllocation = VK_NULL_HANDLE;
+        m_stagingMapped = nullptr;
+    }
+
+    {
+        // Destroying a pool frees all command buffers allocated from it
+        std::lock_guard<std::mutex> contextLock(m_contextMutex);
+        for (auto& context : m_threadContexts) {
+            vkDestroyCommandPool(m_device, context->commandPool, nullptr);
+        }
+        m_threadContexts.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> acquireLock(m_acquireMutex);
+        m_pendingAcquires.clear();
     }
 
     m_transferQueue = VK_NULL_HANDLE;
 }
 
 bool TransferManager::CreateTransferQueue() {
-    // Find transfer queue family
+    // The queue itself is chosen by the renderer at device creation
+    if (m_queueInfo.queue == VK_NULL_HANDLE || m_queueInfo.familyIndex == UINT32_MAX) {
+        std::cerr << "No queue provided for transfer operations" << std::endl;
+        return false;
+    }
+
+    m_transferQueue = m_queueInfo.queue;
+    m_transferQueueFamilyIndex = m_queueInfo.familyIndex;
+
+    // Mip chains are built with blits, which need a graphics-capable queue
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
-    
     std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
     vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+    m_transferSupportsBlit = m_transferQueueFamilyIndex < queueFamilyCount &&
+                             (queueFamilies[m_transferQueueFamilyIndex].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
 
-    uint32_t transferQueueFamilyIndex = UINT32_MAX;
-    for (uint32_t i = 0; i < queueFamilyCount; i++) {
-        if (queueFamilies[i].queueFlags & VK_QUEUE_TRANSFER_BIT) {
-            transferQueueFamilyIndex = i;
-            break;
-        }
-    }
+    std::cout << "Transfer queue family " << m_transferQueueFamilyIndex
+              << (m_queueInfo.submitMutex ? " (shared with graphics)" : " (async)") << std::endl;
+    return true;
+}
 
-    if (transferQueueFamilyIndex == UINT32_MAX) {
-        // Fallback to graphics queue if no dedicated transfer queue
-        for (uint32_t i = 0; i < queueFamilyCount; i++) {
-            if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-                transferQueueFamilyIndex = i;
-                break;
-            }
-        }
+bool TransferManager::CreateTimelineSemaphore() {
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_timelineSemaphore) != VK_SUCCESS) {
+        std::cerr << "Failed to create transfer timeline semaphore" << std::endl;
+        return false;
     }
 
-    if (transferQueueFamilyIndex == UINT32_MAX) {
-        std::cerr << "No suitable queue family found for transfer operations" << std::endl;
+    m_lastSubmittedValue = 0;
+    return true;
+}
+
+bool TransferManager::CreateStagingRing() {
+    // Copy offsets into the ring must satisfy the device's optimal copy alignment
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_stagingAlignment = std::max<VkDeviceSize>(16, properties.limits.optimalBufferCopyOffsetAlignment);
+    m_stagingSize = AlignUp(m_config.stagingRingSize, m_stagingAlignment);
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = m_stagingSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo allocationInfo{};
+    if (vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo, &m_stagingBuffer,
+                        &m_stagingAllocation, &allocationInfo) != VK_SUCCESS) {
+        std::cerr << "Failed to create staging ring buffer" << std::endl;
         return false;
     }
 
-    vkGetDeviceQueue(m_device, transferQueueFamilyIndex, 0, &m_transferQueue);
+    m_stagingMapped = static_cast<uint8_t*>(allocationInfo.pMappedData);
+    m_stagingHead = 0;
+    m_stagingTail = 0;
+    m_stagingUsed = 0;
+    m_ringBlocks.clear();
+    m_firstRingBlock = 1;
+
+    std::cout << "Staging ring created (" << (m_stagingSize / (1024 * 1024)) << " MB)" << std::endl;
     return true;
 }
 
-bool TransferManager::CreateCommandPool() {
-    VkCommandPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    
-    // Find the queue family index for transfer queue
+void TransferManager::DetectUnifiedMemory() {
+    // Integrated GPUs (Quest, laptops) read host-visible memory at full speed,
+    // so geometry is written in place instead of going through the staging ring
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_unifiedMemory = properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU ||
+                      properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+
+    std::cout << "Transfer path: " << (m_unifiedMemory ? "unified memory (direct writes)" : "staged device-local copies")
+              << std::endl;
+}
+
+void TransferManager::CreateTimestampQueries() {
+    // Timing is optional; without timestamp support on the family it stays off
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
-    
     std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
     vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+    uint32_t validBits = queueFamilies[m_transferQueueFamilyIndex].timestampValidBits;
+    if (validBits == 0) {
+        std::cout << "Transfer queue family has no timestamp support, GPU upload timing disabled" << std::endl;
+        return;
+    }
 
-    uint32_t transferQueueFamilyIndex = UINT32_MAX;
-    for (uint32_t i = 0; i < queueFamilyCount; i++) {
-        if (queueFamilies[i].queueFlags & VK_QUEUE_TRANSFER_BIT) {
-            transferQueueFamilyIndex = i;
-            break;
-        }
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_timestampPeriod = properties.limits.timestampPeriod;
+    m_timestampMask = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = kTimestampSlots * 2;
+    if (vkCreateQueryPool(m_device, &poolInfo, nullptr, &m_timestampPool) != VK_SUCCESS) {
+        std::cerr << "Failed to create transfer timestamp query pool" << std::endl;
+        m_timestampPool = VK_NULL_HANDLE;
+        return;
     }
 
-    if (transferQueueFamilyIndex == UINT32_MAX) {
-        // Fallback to graphics queue
-        for (uint32_t i = 0; i < queueFamilyCount; i++) {
-            if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-                transferQueueFamilyIndex = i;
-                break;
-            }
-        }
+    // Queries are reset from the host: transfer queues cannot record resets
+    vkResetQueryPool(m_device, m_timestampPool, 0, poolInfo.queryCount);
+    for (uint32_t slot = kTimestampSlots; slot > 0; slot--) {
+        m_freeTimestampSlots.push_back(slot - 1);
     }
+}
 
-    poolInfo.queueFamilyIndex = transferQueueFamilyIndex;
+uint32_t TransferManager::AcquireTimestampSlot() {
+    std::lock_guard<std::mutex> lock(m_timestampMutex);
+    if (m_freeTimestampSlots.empty()) {
+        return UINT32_MAX; // More batches in flight than slots; this one goes untimed
+    }
+    uint32_t slot = m_freeTimestampSlots.back();
+    m_freeTimestampSlots.pop_back();
+    return slot;
+}
 
-    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
-        std::cerr << "Failed to create transfer command pool" << std::endl;
-        return false;
+void TransferManager::ReleaseTimestampSlot(uint32_t slot) {
+    if (slot == UINT32_MAX) {
+        return;
     }
+    vkResetQueryPool(m_device, m_timestampPool, slot * 2, 2);
 
-    return true;
+    std::lock_guard<std::mutex> lock(m_timestampMutex);
+    m_freeTimestampSlots.push_back(slot);
 }
 
-bool TransferManager::CreateCommandBuffer() {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = m_commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
+TransferManager::ThreadContext* TransferManager::GetThreadContext() {
+    // Each thread caches its context per manager, so only the first upload
+    // from a thread takes a lock
+    thread_local std::unordered_map<uint64_t, ThreadContext*> cachedContexts;
+    auto it = cachedContexts.find(m_instanceId);
+    if (it != cachedContexts.end()) {
+        return it->second;
+    }
 
-    if (vkAllocateCommandBuffers(m_device, &allocInfo, &m_commandBuffer) != VK_SUCCESS) {
-        std::cerr << "Failed to allocate transfer command buffer" << std::endl;
-        return false;
+    auto context = std::make_unique<ThreadContext>();
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = m_transferQueueFamilyIndex;
+
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &context->commandPool) != VK_SUCCESS) {
+        std::cerr << "Failed to create transfer command pool" << std::endl;
+        return nullptr;
     }
 
-    return true;
+    ThreadContext* result = context.get();
+    {
+        std::lock_guard<std::mutex> lock(m_contextMutex);
+        m_threadContexts.push_back(std::move(context));
+    }
+
+    cachedContexts[m_instanceId] = result;
+    return result;
 }
 
-bool TransferManager::CreateFence() {
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = 0; // Not signaled initially
+VkCommandBuffer TransferManager::BeginCommandBuffer(ThreadContext& context) {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
 
-    if (vkCreateFence(m_device, &fenceInfo, nullptr, &m_fence) != VK_SUCCESS) {
-        std::cerr << "Failed to create transfer fence" << std::endl;
-        return false;
+    // Pick up command buffers whose submissions have retired since last time
+    if (context.freeCommandBuffers.empty()) {
+        std::lock_guard<std::mutex> lock(context.retiredMutex);
+        context.freeCommandBuffers.swap(context.retired);
     }
 
-    return true;
+    if (!context.freeCommandBuffers.empty()) {
+        commandBuffer = context.freeCommandBuffers.back();
+        context.freeCommandBuffers.pop_back();
+        vkResetCommandBuffer(commandBuffer, 0);
+    } else {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = context.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            std::cerr << "Failed to allocate transfer command buffer" << std::endl;
+            return VK_NULL_HANDLE;
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        std::cerr << "Failed to begin transfer command buffer" << std::endl;
+        context.freeCommandBuffers.push_back(commandBuffer);
+        return VK_NULL_HANDLE;
+    }
+
+    return commandBuffer;
 }
 
 bool TransferManager::CreateBuffer(VkBufferCreateInfo& bufferInfo, VmaAllocationCreateInfo& allocInfo,
                                   VkBuffer& buffer, VmaAllocation& allocation) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
     VkResult result = vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo, &buffer, &allocation, nullptr);
     if (result != VK_SUCCESS) {
         std::cerr << "Failed to create buffer with VMA" << std::endl;
@@ -174,28 +416,50 @@ bool TransferManager::CreateBuffer(VkBufferCreateInfo& bufferInfo, VmaAllocation
     return true;
 }
 
-bool TransferManager::UploadBufferData(VkBuffer buffer, VmaAllocation allocation, 
-                                      const void* data, size_t dataSize) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+bool TransferManager::CreateStaticBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                                        VkBuffer& buffer, VmaAllocation& allocation) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    // Map memory and copy data
-    void* mappedData;
-    VkResult result = vmaMapMemory(m_allocator, allocation, &mappedData);
-    if (result != VK_SUCCESS) {
-        std::cerr << "Failed to map buffer memory" << std::endl;
-        return false;
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    if (m_unifiedMemory) {
+        // Device memory is host-visible here, so skip the staging copy
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
     }
 
-    memcpy(mappedData, data, dataSize);
-    vmaUnmapMemory(m_allocator, allocation);
+    return CreateBuffer(bufferInfo, allocInfo, buffer, allocation);
+}
 
-    return true;
+TransferTicket TransferManager::UploadBufferDataAsync(VkBuffer buffer, VmaAllocation allocation,
+                                                      const void* data, size_t dataSize, VkDeviceSize dstOffset) {
+    TransferBatch batch = BeginBatch();
+    batch.AddBufferCopy(buffer, allocation, data, dataSize, dstOffset);
+
+    TransferTicket ticket;
+    if (!CommitBatch(batch, ticket)) {
+        return {};
+    }
+    return ticket;
+}
+
+bool TransferManager::UploadBufferData(VkBuffer buffer, VmaAllocation allocation,
+                                      const void* data, size_t dataSize) {
+    TransferBatch batch = BeginBatch();
+    batch.AddBufferCopy(buffer, allocation, data, dataSize);
+
+    TransferTicket ticket;
+    if (!CommitBatch(batch, ticket)) {
+        return false;
+    }
+    return Wait(ticket);
 }
 
 bool TransferManager::CreateImage(VkImageCreateInfo& imageInfo, VmaAllocationCreateInfo& allocInfo,
                                  VkImage& image, VmaAllocation& allocation) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
     VkResult result = vmaCreateImage(m_allocator, &imageInfo, &allocInfo, &image, &allocation, nullptr);
     if (result != VK_SUCCESS) {
         std::cerr << "Failed to create image with VMA" << std::endl;
@@ -205,134 +469,941 @@ bool TransferManager::CreateImage(VkImageCreateInfo& imageInfo, VmaAllocationCre
     return true;
 }
 
-bool TransferManager::UploadImageData(VkImage image, VkImageCreateInfo& imageInfo,
-                                     const void* data, size_t dataSize) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    // Reset command buffer
-    vkResetCommandBuffer(m_commandBuffer, 0);
+TransferTicket TransferManager::UploadImageDataAsync(VkImage image, const VkImageCreateInfo& imageInfo,
+                                                     const void* data, size_t dataSize) {
+    TransferBatch batch = BeginBatch();
+    batch.AddImageCopy(image, imageInfo, data, dataSize);
 
-    // Begin command buffer
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    TransferTicket ticket;
+    if (!CommitBatch(batch, ticket)) {
+        return {};
+    }
+    return ticket;
+}
 
-    if (vkBeginCommandBuffer(m_commandBuffer, &beginInfo) != VK_SUCCESS) {
-        std::cerr << "Failed to begin command buffer for image upload" << std::endl;
+bool TransferManager::UploadImageData(VkImage image, VkImageCreateInfo& imageInfo,
+                                     const void* data, size_t dataSize) {
+    TransferTicket ticket = UploadImageDataAsync(image, imageInfo, data, dataSize);
+    if (!ticket.IsValid()) {
         return false;
     }
 
-    // Create staging buffer
-    VkBufferCreateInfo stagingBufferInfo{};
-    stagingBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    stagingBufferInfo.size = dataSize;
-    stagingBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    stagingBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VmaAllocationCreateInfo stagingAllocInfo = {};
-    stagingAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    stagingAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+    return Wait(ticket);
+}
 
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingAllocation;
-    VkResult result = vmaCreateBuffer(m_allocator, &stagingBufferInfo, &stagingAllocInfo, 
-                                     &stagingBuffer, &stagingAllocation, nullptr);
-    if (result != VK_SUCCESS) {
-        std::cerr << "Failed to create staging buffer" << std::endl;
-        vkEndCommandBuffer(m_commandBuffer);
+bool TransferManager::WriteBufferDirect(const TransferBatch::BufferCopy& copy) {
+    void* mappedData = nullptr;
+    if (vmaMapMemory(m_allocator, copy.allocation, &mappedData) != VK_SUCCESS) {
+        std::cerr << "Failed to map buffer memory" << std::endl;
         return false;
     }
 
-    // Copy data to staging buffer
-    void* stagingData;
-    result = vmaMapMemory(m_allocator, stagingAllocation, &stagingData);
-    if (result != VK_SUCCESS) {
-        std::cerr << "Failed to map staging buffer memory" << std::endl;
-        vmaDestroyBuffer(m_allocator, stagingBuffer, stagingAllocation);
-        vkEndCommandBuffer(m_commandBuffer);
-        return false;
+    memcpy(static_cast<uint8_t*>(mappedData) + copy.dstOffset, copy.data, copy.size);
+    vmaFlushAllocation(m_allocator, copy.allocation, copy.dstOffset, copy.size);
+    vmaUnmapMemory(m_allocator, copy.allocation);
+    return true;
+}
+
+uint32_t TransferManager::GetMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    uint32_t size = std::max(width, height);
+    while (size > 1) {
+        size >>= 1;
+        levels++;
     }
+    return levels;
+}
 
-    memcpy(stagingData, data, dataSize);
-    vmaUnmapMemory(m_allocator, stagingAllocation);
+bool TransferManager::SupportsMipGeneration(VkFormat format) const {
+    // Blit chains need linear filtering and blit support on optimal tiling
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(m_physicalDevice, format, &properties);
+    VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                    VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (properties.optimalTilingFeatures & required) == required;
+}
 
-    // Transition image to transfer destination
+void TransferManager::RecordMipChain(VkCommandBuffer commandBuffer, VkImage image, VkExtent3D extent,
+                                     uint32_t mipLevels, uint32_t arrayLayers) {
+    // Expects every level in TRANSFER_DST with level 0 written. Leaves levels
+    // [0, mipLevels - 1) in TRANSFER_SRC and the last level in TRANSFER_DST.
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = imageInfo.mipLevels;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = imageInfo.arrayLayers;
-
-    vkCmdPipelineBarrier(m_commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 
-                        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-    // Copy buffer to image
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {imageInfo.extent.width, imageInfo.extent.height, imageInfo.extent.depth};
-
-    vkCmdCopyBufferToImage(m_commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    // Transition image to shader read optimal
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, arrayLayers};
+
+    int32_t width = static_cast<int32_t>(extent.width);
+    int32_t height = static_cast<int32_t>(extent.height);
+
+    for (uint32_t level = 1; level < mipLevels; level++) {
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                            0, nullptr, 0, nullptr, 1, &barrier);
+
+        int32_t nextWidth = std::max(width / 2, 1);
+        int32_t nextHeight = std::max(height / 2, 1);
+
+        VkImageBlit blit{};
+        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, arrayLayers};
+        blit.srcOffsets[1] = {width, height, 1};
+        blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, arrayLayers};
+        blit.dstOffsets[1] = {nextWidth, nextHeight, 1};
+
+        vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+void TransferManager::AppendShaderReadBarriers(VkImage image, uint32_t mipLevels, uint32_t arrayLayers,
+                                               bool mipsGenerated, std::vector<VkImageMemoryBarrier>& barriers) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+
+    // Levels that were blit sources are in TRANSFER_SRC; the rest in TRANSFER_DST
+    uint32_t sourceLevels = mipsGenerated ? mipLevels - 1 : 0;
+    if (sourceLevels > 0) {
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, sourceLevels, 0, arrayLayers};
+        barriers.push_back(barrier);
+    }
 
-    vkCmdPipelineBarrier(m_commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, 
-                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, sourceLevels, mipLevels - sourceLevels, 0, arrayLayers};
+    barriers.push_back(barrier);
+}
+
+TransferBatch TransferManager::BeginBatch(TransferPriority priority) const {
+    TransferBatch batch;
+    batch.m_priority = priority;
+    return batch;
+}
+
+bool TransferManager::CommitBatch(TransferBatch& batch, TransferTicket& ticket) {
+    ticket = {};
 
-    // End command buffer
-    if (vkEndCommandBuffer(m_commandBuffer) != VK_SUCCESS) {
-        std::cerr << "Failed to end command buffer for image upload" << std::endl;
-        vmaDestroyBuffer(m_allocator, stagingBuffer, stagingAllocation);
+    // Host-visible destinations are written in place and need no GPU work
+    std::vector<const TransferBatch::BufferCopy*> stagedBuffers;
+    for (const auto& copy : batch.m_bufferCopies) {
+        VkMemoryPropertyFlags memoryFlags = 0;
+        vmaGetAllocationMemoryProperties(m_allocator, copy.allocation, &memoryFlags);
+        if (memoryFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+            if (!WriteBufferDirect(copy)) {
+                return false;
+            }
+            AddUploadedBytes(copy.size);
+        } else {
+            stagedBuffers.push_back(&copy);
+        }
+    }
+
+    // Lay every staged copy out in one contiguous staging region
+    std::vector<VkDeviceSize> bufferOffsets;
+    std::vector<VkDeviceSize> imageOffsets;
+    VkDeviceSize stagingSize = 0;
+    for (const auto* copy : stagedBuffers) {
+        stagingSize = AlignUp(stagingSize, m_stagingAlignment);
+        bufferOffsets.push_back(stagingSize);
+        stagingSize += copy->size;
+    }
+    for (const auto& copy : batch.m_imageCopies) {
+        stagingSize = AlignUp(stagingSize, m_stagingAlignment);
+        imageOffsets.push_back(stagingSize);
+        stagingSize += copy.size;
+    }
+
+    batch.m_bufferCopies.clear();
+    if (stagingSize == 0) {
+        batch.m_imageCopies.clear();
+        return true;
+    }
+
+    // Recording happens on this thread's own command pool without a lock
+    ThreadContext* context = GetThreadContext();
+    VkCommandBuffer commandBuffer = context ? BeginCommandBuffer(*context) : VK_NULL_HANDLE;
+    if (commandBuffer == VK_NULL_HANDLE) {
+        batch.m_imageCopies.clear();
         return false;
     }
 
-    // Submit command buffer
-    if (!SubmitCommandBuffer()) {
-        vmaDestroyBuffer(m_allocator, stagingBuffer, stagingAllocation);
+    // Sub-allocate upload space; this blocks while the ring is full
+    StagingRegion staging;
+    if (!AllocateStaging(stagingSize, staging)) {
+        std::cerr << "Failed to allocate staging memory for transfer batch" << std::endl;
+        vkEndCommandBuffer(commandBuffer);
+        context->freeCommandBuffers.push_back(commandBuffer);
+        batch.m_imageCopies.clear();
         return false;
     }
 
-    // Cleanup staging buffer
-    vmaDestroyBuffer(m_allocator, stagingBuffer, stagingAllocation);
+    uint8_t* stagingData = static_cast<uint8_t*>(staging.mapped);
+    for (size_t i = 0; i < stagedBuffers.size(); i++) {
+        memcpy(stagingData + bufferOffsets[i], stagedBuffers[i]->data, stagedBuffers[i]->size);
+    }
+    for (size_t i = 0; i < batch.m_imageCopies.size(); i++) {
+        memcpy(stagingData + imageOffsets[i], batch.m_imageCopies[i].data, batch.m_imageCopies[i].size);
+    }
+    FlushStaging(staging, stagingSize);
+
+    // Bracket the batch with timestamps for the transfer time histogram
+    uint32_t timestampSlot = m_timestampPool != VK_NULL_HANDLE ? AcquireTimestampSlot() : UINT32_MAX;
+    if (timestampSlot != UINT32_MAX) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampPool, timestampSlot * 2);
+    }
+
+    // Transition all images to transfer destination in one barrier
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    for (const auto& copy : batch.m_imageCopies) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = copy.image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = copy.mipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = copy.arrayLayers;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        imageBarriers.push_back(barrier);
+    }
+
+    if (!imageBarriers.empty()) {
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                            static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    }
+
+    // Record the copies
+    for (size_t i = 0; i < stagedBuffers.size(); i++) {
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = staging.offset + bufferOffsets[i];
+        copyRegion.dstOffset = stagedBuffers[i]->dstOffset;
+        copyRegion.size = stagedBuffers[i]->size;
+        vkCmdCopyBuffer(commandBuffer, staging.buffer, stagedBuffers[i]->buffer, 1, &copyRegion);
+    }
+
+    for (size_t i = 0; i < batch.m_imageCopies.size(); i++) {
+        const auto& copy = batch.m_imageCopies[i];
+
+        // One region per provided mip level, covering all array layers
+        std::vector<VkBufferImageCopy> regions;
+        for (uint32_t level = 0; level < copy.levelOffsets.size(); level++) {
+            VkBufferImageCopy region{};
+            region.bufferOffset = staging.offset + imageOffsets[i] + copy.levelOffsets[level];
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = copy.arrayLayers;
+            region.imageOffset = {0, 0, 0};
+            region.imageExtent = {std::max(1u, copy.extent.width >> level),
+                                  std::max(1u, copy.extent.height >> level),
+                                  std::max(1u, copy.extent.depth >> level)};
+            regions.push_back(region);
+        }
+
+        vkCmdCopyBufferToImage(commandBuffer, staging.buffer, copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    // Transition images to shader read optimal; with separate queue families
+    // this is the release half of the ownership transfer
+    PendingAcquire acquire;
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    std::vector<VkImageMemoryBarrier> finalBarriers;
+    bool ownershipTransfer = NeedsOwnershipTransfer();
+
+    for (const auto& copy : batch.m_imageCopies) {
+        bool generateMips = copy.generateMips && copy.levelOffsets.size() < copy.mipLevels;
+
+        if (generateMips && !m_transferSupportsBlit) {
+            // Transfer-only queues cannot blit. Hand the image over still in
+            // TRANSFER_DST and let the graphics queue build the chain.
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = m_transferQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = m_graphicsQueueFamilyIndex;
+            barrier.image = copy.image;
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, copy.mipLevels, 0, copy.arrayLayers};
+            finalBarriers.push_back(barrier);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            acquire.imageBarriers.push_back(barrier);
 
+            PendingAcquire::MipGeneration mipGeneration;
+            mipGeneration.image = copy.image;
+            mipGeneration.extent = copy.extent;
+            mipGeneration.mipLevels = copy.mipLevels;
+            mipGeneration.arrayLayers = copy.arrayLayers;
+            acquire.mipGenerations.push_back(mipGeneration);
+            continue;
+        }
+
+        if (generateMips) {
+            RecordMipChain(commandBuffer, copy.image, copy.extent, copy.mipLevels, copy.arrayLayers);
+        }
+
+        size_t firstBarrier = finalBarriers.size();
+        AppendShaderReadBarriers(copy.image, copy.mipLevels, copy.arrayLayers, generateMips, finalBarriers);
+        for (size_t i = firstBarrier; i < finalBarriers.size(); i++) {
+            VkImageMemoryBarrier& barrier = finalBarriers[i];
+            if (ownershipTransfer) {
+                barrier.dstAccessMask = 0;
+                barrier.srcQueueFamilyIndex = m_transferQueueFamilyIndex;
+                barrier.dstQueueFamilyIndex = m_graphicsQueueFamilyIndex;
+
+                VkImageMemoryBarrier acquireBarrier = barrier;
+                acquireBarrier.srcAccessMask = 0;
+                acquireBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                acquire.imageBarriers.push_back(acquireBarrier);
+            }
+        }
+    }
+
+    if (ownershipTransfer) {
+        for (const auto* copy : stagedBuffers) {
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = m_transferQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = m_graphicsQueueFamilyIndex;
+            barrier.buffer = copy->buffer;
+            barrier.offset = copy->dstOffset;
+            barrier.size = copy->size;
+            bufferBarriers.push_back(barrier);
+
+            barrier.srcAccessMask = 0;
+            // Skinned geometry is also read by the skinning compute pass
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                    VK_ACCESS_SHADER_READ_BIT;
+            acquire.bufferBarriers.push_back(barrier);
+        }
+    }
+
+    if (!finalBarriers.empty() || !bufferBarriers.empty()) {
+        VkPipelineStageFlags dstStage = ownershipTransfer ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
+                                                          : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage, 0, 0, nullptr,
+                            static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                            static_cast<uint32_t>(finalBarriers.size()), finalBarriers.data());
+    }
+
+    batch.m_imageCopies.clear();
+
+    if (timestampSlot != UINT32_MAX) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampPool,
+                            timestampSlot * 2 + 1);
+    }
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        std::cerr << "Failed to end command buffer for transfer batch" << std::endl;
+        ReleaseStaging(staging);
+        ReleaseTimestampSlot(timestampSlot);
+        context->freeCommandBuffers.push_back(commandBuffer);
+        return false;
+    }
+
+    // Hand off to the submit point; the staging region stays reserved until
+    // the ticket retires
+    ticket = EnqueueSubmission(commandBuffer, *context, staging, std::move(acquire), stagingSize, batch.m_priority,
+                               timestampSlot);
     return true;
 }
 
-bool TransferManager::SubmitCommandBuffer() {
+TransferTicket TransferManager::EnqueueSubmission(VkCommandBuffer commandBuffer, ThreadContext& context,
+                                                  const StagingRegion& staging, PendingAcquire acquire,
+                                                  VkDeviceSize bytes, TransferPriority priority,
+                                                  uint32_t timestampSlot) {
+    auto* submission = new PendingSubmission();
+    submission->commandBuffer = commandBuffer;
+    submission->context = &context;
+    submission->staging = staging;
+    submission->acquire = std::move(acquire);
+    submission->timelineValue = std::make_shared<std::atomic<uint64_t>>(0);
+    submission->bytes = bytes;
+    submission->priority = priority;
+    submission->timestampSlot = timestampSlot;
+
+    size_t queueIndex = static_cast<size_t>(priority);
+    m_queuedBatches[queueIndex]++;
+    m_queuedBytes[queueIndex] += bytes;
+
+    TransferTicket ticket;
+    ticket.m_batches.push_back(submission->timelineValue);
+
+    // Lock-free push; the submit point is the single consumer
+    submission->next = m_pendingHead.load(std::memory_order_relaxed);
+    while (!m_pendingHead.compare_exchange_weak(submission->next, submission,
+                                                std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    return ticket;
+}
+
+void TransferManager::FlushSubmissions() {
+    VkDeviceSize budget = m_config.frameUploadBudget > 0 ? m_config.frameUploadBudget : UINT64_MAX;
+    SubmitQueued(budget, 1, nullptr);
+    UpdateFrameStats();
+}
+
+TransferStats TransferManager::GetStats() const {
+    TransferStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        stats = m_stats;
+    }
+
+    for (size_t i = 0; i < kPriorityCount; i++) {
+        stats.queuedBatches += m_queuedBatches[i].load();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        stats.inFlightBatches = static_cast<uint32_t>(m_inFlight.size());
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_stagingMutex);
+        stats.stagingUsed = m_stagingUsed;
+    }
+    return stats;
+}
+
+void TransferManager::AddUploadedBytes(VkDeviceSize bytes) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.totalBytes += bytes;
+    m_frameBytes += bytes;
+    m_windowBytes += bytes;
+}
+
+void TransferManager::RecordRetirement(const InFlightSubmission& submission,
+                                       std::chrono::steady_clock::time_point now) {
+    double latencyMs = std::chrono::duration<double, std::milli>(now - submission.submitTime).count();
+
+    double gpuTimeMs = -1.0;
+    if (submission.timestampSlot != UINT32_MAX) {
+        uint64_t timestamps[2] = {};
+        VkResult result = vkGetQueryPoolResults(m_device, m_timestampPool, submission.timestampSlot * 2, 2,
+                                                sizeof(timestamps), timestamps, sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT);
+        // Not ready when the submit failed and the timeline was signaled by the host
+        if (result == VK_SUCCESS) {
+            uint64_t ticks = ((timestamps[1] & m_timestampMask) - (timestamps[0] & m_timestampMask)) & m_timestampMask;
+            gpuTimeMs = static_cast<double>(ticks) * m_timestampPeriod / 1.0e6;
+        }
+        ReleaseTimestampSlot(submission.timestampSlot);
+    }
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.submitLatency[TransferStats::GetLatencyBucket(latencyMs)]++;
+    m_stats.maxSubmitLatencyMs = std::max(m_stats.maxSubmitLatencyMs, latencyMs);
+    if (gpuTimeMs >= 0.0) {
+        m_stats.gpuTime[TransferStats::GetLatencyBucket(gpuTimeMs)]++;
+        m_stats.maxGpuTimeMs = std::max(m_stats.maxGpuTimeMs, gpuTimeMs);
+    }
+}
+
+void TransferManager::UpdateFrameStats() {
+    auto now = std::chrono::steady_clock::now();
+    bool output = false;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.frameBytes = m_frameBytes;
+        m_frameBytes = 0;
+
+        // Rate over roughly one-second windows so it does not jitter per frame
+        double windowSeconds = std::chrono::duration<double>(now - m_windowStart).count();
+        if (windowSeconds >= 1.0) {
+            m_stats.bytesPerSecond = static_cast<double>(m_windowBytes) / windowSeconds;
+            m_windowBytes = 0;
+            m_windowStart = now;
+        }
+
+        double sinceOutput = std::chrono::duration<double>(now - m_lastStatsOutput).count();
+        if (m_config.statsIntervalSeconds > 0.0f && sinceOutput >= m_config.statsIntervalSeconds) {
+            m_lastStatsOutput = now;
+            output = true;
+        }
+    }
+
+    if (output) {
+        OutputStats(GetStats());
+    }
+}
+
+void TransferManager::OutputStats(const TransferStats& stats) {
+    std::cout << "Transfer: " << stats.frameBytes / 1024 << " KB/frame, "
+              << stats.bytesPerSecond / (1024.0 * 1024.0) << " MB/s, "
+              << stats.queuedBatches << " queued, " << stats.inFlightBatches << " in flight, staging "
+              << stats.stagingUsed / 1024 << "/" << stats.stagingSize / 1024 << " KB (peak "
+              << stats.stagingHighWater / 1024 << " KB), max latency " << stats.maxSubmitLatencyMs
+              << " ms, max GPU " << stats.maxGpuTimeMs << " ms, stalls " << stats.waitStallMs << "/"
+              << stats.stagingStallMs << " ms" << std::endl;
+
+    if (m_statsCsv.is_open()) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        m_statsCsv << seconds << ',' << stats.totalBytes << ',' << stats.totalBatches << ','
+                   << stats.frameBytes << ',' << stats.bytesPerSecond << ',' << stats.queuedBatches << ','
+                   << stats.inFlightBatches << ',' << stats.stagingUsed << ',' << stats.stagingHighWater << ','
+                   << stats.maxSubmitLatencyMs << ',' << stats.maxGpuTimeMs << ',' << stats.waitStallMs << ','
+                   << stats.stagingStallMs << '\n';
+        m_statsCsv.flush();
+    }
+}
+
+TransferBacklog TransferManager::GetBacklog() const {
+    TransferBacklog backlog;
+    for (size_t i = 0; i < kPriorityCount; i++) {
+        backlog.batches[i] = m_queuedBatches[i].load();
+        backlog.bytes[i] = m_queuedBytes[i].load();
+    }
+    return backlog;
+}
+
+void TransferManager::SubmitQueued(VkDeviceSize byteBudget, size_t minBatches,
+                                   const std::atomic<uint64_t>* requiredBatch) {
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+
+    // Take everything pushed so far. The stack hands it back newest first, so
+    // prepend to keep each priority queue in commit order.
+    PendingSubmission* node = m_pendingHead.exchange(nullptr, std::memory_order_acquire);
+    std::vector<PendingSubmission*> drained;
+    while (node) {
+        drained.push_back(node);
+        node = node->next;
+    }
+    for (auto it = drained.rbegin(); it != drained.rend(); ++it) {
+        m_queuedSubmissions[static_cast<size_t>((*it)->priority)].push_back(*it);
+    }
+
+    // Critical work always goes; the rest is taken in priority order until the
+    // budget is spent. Stopping at the first batch that does not fit keeps a
+    // large batch from being starved by smaller ones behind it.
+    std::vector<PendingSubmission*> submissions;
+    VkDeviceSize spentBytes = 0;
+    bool budgetSpent = false;
+    for (size_t i = 0; i < kPriorityCount && !budgetSpent; i++) {
+        auto& queue = m_queuedSubmissions[i];
+        bool critical = i == static_cast<size_t>(TransferPriority::Critical);
+        while (!queue.empty()) {
+            PendingSubmission* submission = queue.front();
+            bool fits = byteBudget == UINT64_MAX || spentBytes + submission->bytes <= byteBudget;
+            if (!critical && !fits && submissions.size() >= minBatches) {
+                budgetSpent = true;
+                break;
+            }
+            if (!critical) {
+                spentBytes += submission->bytes;
+            }
+            submissions.push_back(submission);
+            queue.pop_front();
+        }
+    }
+
+    // A waiter needs this particular batch now, whatever its priority
+    if (requiredBatch) {
+        for (auto& queue : m_queuedSubmissions) {
+            auto it = std::find_if(queue.begin(), queue.end(), [requiredBatch](const PendingSubmission* submission) {
+                return submission->timelineValue.get() == requiredBatch;
+            });
+            if (it != queue.end()) {
+                submissions.push_back(*it);
+                queue.erase(it);
+                break;
+            }
+        }
+    }
+
+    if (submissions.empty()) {
+        return;
+    }
+
+    // Values are assigned here, at submission, so the timeline only moves
+    // forward; all batches in one submission share its signal value
+    std::vector<VkCommandBuffer> commandBuffers;
+    for (auto* submission : submissions) {
+        commandBuffers.push_back(submission->commandBuffer);
+    }
+    uint64_t signalValue = m_lastSubmittedValue.load() + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffer;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+    submitInfo.pCommandBuffers = commandBuffers.data();
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &m_timelineSemaphore;
+
+    VkResult result;
+    if (m_queueInfo.submitMutex) {
+        std::lock_guard<std::mutex> queueLock(*m_queueInfo.submitMutex);
+        result = vkQueueSubmit(m_transferQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    } else {
+        result = vkQueueSubmit(m_transferQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    }
+
+    if (result != VK_SUCCESS) {
+        // Signal from the host so nobody waits forever on the lost uploads
+        std::cerr << "Failed to submit transfer command buffers" << std::endl;
+        VkSemaphoreSignalInfo signalInfo{};
+        signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+        signalInfo.semaphore = m_timelineSemaphore;
+        signalInfo.value = signalValue;
+        vkSignalSemaphore(m_device, &signalInfo);
+    }
+
+    auto submitTime = std::chrono::steady_clock::now();
+    VkDeviceSize submittedBytes = 0;
+    {
+        // Every batch of this submission retires with the signal value
+        std::lock_guard<std::mutex> inFlightLock(m_inFlightMutex);
+        for (const auto* submission : submissions) {
+            InFlightSubmission inFlight;
+            inFlight.commandBuffer = submission->commandBuffer;
+            inFlight.context = submission->context;
+            inFlight.staging = submission->staging;
+            inFlight.timelineValue = signalValue;
+            inFlight.timestampSlot = submission->timestampSlot;
+            inFlight.submitTime = submitTime;
+            m_inFlight.push_back(inFlight);
+            submittedBytes += submission->bytes;
+        }
+    }
+    AddUploadedBytes(submittedBytes);
+    {
+        std::lock_guard<std::mutex> statsLock(m_statsMutex);
+        m_stats.totalBatches += submissions.size();
+    }
+    m_lastSubmittedValue.store(signalValue);
+
+    for (auto* submission : submissions) {
+        size_t queueIndex = static_cast<size_t>(submission->priority);
+        m_queuedBatches[queueIndex]--;
+        m_queuedBytes[queueIndex] -= submission->bytes;
+
+        PendingAcquire& acquire = submission->acquire;
+        if (result == VK_SUCCESS && (!acquire.bufferBarriers.empty() || !acquire.imageBarriers.empty())) {
+            acquire.timelineValue = signalValue;
+            QueueAcquire(std::move(acquire));
+        }
+
+        submission->timelineValue->store(signalValue);
+        delete submission;
+    }
+}
+
+void TransferManager::QueueAcquire(PendingAcquire acquire) {
+    std::lock_guard<std::mutex> lock(m_acquireMutex);
+    m_pendingAcquires.push_back(std::move(acquire));
+}
+
+uint64_t TransferManager::RecordOwnershipAcquires(VkCommandBuffer graphicsCommandBuffer) {
+    std::vector<PendingAcquire> acquires;
+    {
+        std::lock_guard<std::mutex> lock(m_acquireMutex);
+        acquires.swap(m_pendingAcquires);
+    }
+
+    if (acquires.empty()) {
+        return 0;
+    }
+
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    uint64_t waitValue = 0;
+    for (const auto& acquire : acquires) {
+        bufferBarriers.insert(bufferBarriers.end(), acquire.bufferBarriers.begin(), acquire.bufferBarriers.end());
+        imageBarriers.insert(imageBarriers.end(), acquire.imageBarriers.begin(), acquire.imageBarriers.end());
+        waitValue = std::max(waitValue, acquire.timelineValue);
+    }
+
+    // Source stages match the timeline wait the renderer adds to its submit, so
+    // the acquire (and any layout transition) is ordered after the transfer
+    vkCmdPipelineBarrier(graphicsCommandBuffer, kAcquireStages, kAcquireStages, 0,
+                        0, nullptr,
+                        static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                        static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+
+    // Build the mip chains the transfer queue could not blit
+    std::vector<VkImageMemoryBarrier> mipBarriers;
+    for (const auto& acquire : acquires) {
+        for (const auto& job : acquire.mipGenerations) {
+            RecordMipChain(graphicsCommandBuffer, job.image, job.extent, job.mipLevels, job.arrayLayers);
+            AppendShaderReadBarriers(job.image, job.mipLevels, job.arrayLayers, true, mipBarriers);
+        }
+    }
+
+    if (!mipBarriers.empty()) {
+        vkCmdPipelineBarrier(graphicsCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr,
+                            static_cast<uint32_t>(mipBarriers.size()), mipBarriers.data());
+    }
+
+    return waitValue;
+}
+
+bool TransferManager::IsComplete(const TransferTicket& ticket) const {
+    uint64_t completedValue = GetCompletedValue();
+    for (const auto& batch : ticket.m_batches) {
+        uint64_t value = batch->load();
+        if (value == 0 || value > completedValue) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    if (vkQueueSubmit(m_transferQueue, 1, &submitInfo, m_fence) != VK_SUCCESS) {
-        std::cerr << "Failed to submit transfer command buffer" << std::endl;
+bool TransferManager::Wait(const TransferTicket& ticket, uint64_t timeoutNs) {
+    auto waitStart = std::chrono::steady_clock::now();
+    auto recordStall = [this, waitStart]() {
+        double stallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.waitStallMs += stallMs;
+    };
+
+    // Batches still queued for the submit point are pushed out right away
+    uint64_t waitValue = 0;
+    for (const auto& batch : ticket.m_batches) {
+        if (batch->load() == 0) {
+            SubmitQueued(0, 0, batch.get());
+        }
+        waitValue = std::max(waitValue, batch->load());
+    }
+
+    if (waitValue == 0) {
+        return true;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_timelineSemaphore;
+    waitInfo.pValues = &waitValue;
+
+    VkResult result = vkWaitSemaphores(m_device, &waitInfo, timeoutNs);
+    recordStall();
+    if (result != VK_SUCCESS) {
+        if (result != VK_TIMEOUT) {
+            std::cerr << "Failed to wait for transfer value " << waitValue << std::endl;
+        }
         return false;
     }
 
-    WaitForCompletion();
     return true;
 }
 
-void TransferManager::WaitForCompletion() {
-    vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, UINT64_MAX);
-    vkResetFences(m_device, 1, &m_fence);
+uint64_t TransferManager::GetCompletedValue() const {
+    uint64_t value = 0;
+    if (m_timelineSemaphore != VK_NULL_HANDLE) {
+        vkGetSemaphoreCounterValue(m_device, m_timelineSemaphore, &value);
+    }
+    return value;
+}
+
+void TransferManager::CollectCompleted() {
+    uint64_t completedValue = GetCompletedValue();
+
+    // Submissions retire in order on the transfer queue
+    std::vector<InFlightSubmission> retired;
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        while (!m_inFlight.empty() && m_inFlight.front().timelineValue <= completedValue) {
+            retired.push_back(m_inFlight.front());
+            m_inFlight.pop_front();
+        }
+    }
+
+    // Command buffers go back to the thread that owns their pool
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& submission : retired) {
+        RecordRetirement(submission, now);
+        ReleaseStaging(submission.staging);
+
+        std::lock_guard<std::mutex> lock(submission.context->retiredMutex);
+        submission.context->retired.push_back(submission.commandBuffer);
+    }
+}
+
+bool TransferManager::AllocateStaging(VkDeviceSize size, StagingRegion& region) {
+    region = StagingRegion{};
+
+    // Uploads that can never fit in the ring get a one-off buffer
+    if (AlignUp(size, m_stagingAlignment) > m_stagingSize) {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocationInfo{};
+        if (vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo, &region.buffer,
+                            &region.dedicatedAllocation, &allocationInfo) != VK_SUCCESS) {
+            return false;
+        }
+
+        std::cout << "Upload of " << size << " bytes exceeds the staging ring, using a dedicated buffer" << std::endl;
+        region.mapped = allocationInfo.pMappedData;
+        return true;
+    }
+
+    // Apply back-pressure: retire the oldest submission until the request fits
+    auto stallStart = std::chrono::steady_clock::now();
+    bool stalled = false;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_stagingMutex);
+            if (TryAllocateFromRing(size, region)) {
+                break;
+            }
+        }
+        stalled = true;
+
+        uint64_t oldestValue = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_inFlightMutex);
+            if (!m_inFlight.empty()) {
+                oldestValue = m_inFlight.front().timelineValue;
+            }
+        }
+
+        if (oldestValue == 0) {
+            // Nothing on the GPU: the ring is held by queued batches, which
+            // have to go out now even past the frame budget, or by batches
+            // other threads are still recording
+            SubmitQueued(0, 1, nullptr);
+            std::this_thread::yield();
+            continue;
+        }
+
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_timelineSemaphore;
+        waitInfo.pValues = &oldestValue;
+        if (vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+            return false;
+        }
+
+        CollectCompleted();
+    }
+
+    if (stalled) {
+        double stallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stallStart).count();
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.stagingStallMs += stallMs;
+    }
+    return true;
+}
+
+bool TransferManager::TryAllocateFromRing(VkDeviceSize size, StagingRegion& region) {
+    VkDeviceSize alignedSize = AlignUp(size, m_stagingAlignment);
+    VkDeviceSize offset = 0;
+    VkDeviceSize padding = 0;
+
+    if (m_stagingUsed == 0) {
+        m_stagingHead = 0;
+        m_stagingTail = 0;
+    } else if (m_stagingHead == m_stagingTail) {
+        // Head caught up with the tail: the ring is completely full
+        return false;
+    } else if (m_stagingHead > m_stagingTail) {
+        // Free space is [head, size) followed by [0, tail)
+        if (m_stagingSize - m_stagingHead >= alignedSize) {
+            offset = m_stagingHead;
+        } else if (m_stagingTail >= alignedSize) {
+            padding = m_stagingSize - m_stagingHead;
+        } else {
+            return false;
+        }
+    } else {
+        // Free space is [head, tail)
+        if (m_stagingTail - m_stagingHead < alignedSize) {
+            return false;
+        }
+        offset = m_stagingHead;
+    }
+
+    m_stagingHead = offset + alignedSize;
+    m_stagingUsed += alignedSize + padding;
+    {
+        std::lock_guard<std::mutex> statsLock(m_statsMutex);
+        m_stats.stagingHighWater = std::max(m_stats.stagingHighWater, m_stagingUsed);
+    }
+
+    RingBlock block;
+    block.end = m_stagingHead;
+    block.consumed = alignedSize + padding;
+    m_ringBlocks.push_back(block);
+
+    region.buffer = m_stagingBuffer;
+    region.offset = offset;
+    region.mapped = m_stagingMapped + offset;
+    region.ringBlock = m_firstRingBlock + m_ringBlocks.size() - 1;
+    return true;
+}
+
+void TransferManager::ReleaseStaging(const StagingRegion& region) {
+    if (region.dedicatedAllocation != VK_NULL_HANDLE) {
+        vmaDestroyBuffer(m_allocator, region.buffer, region.dedicatedAllocation);
+        return;
+    }
+
+    if (region.ringBlock == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_stagingMutex);
+    m_ringBlocks[region.ringBlock - m_firstRingBlock].released = true;
+
+    // The tail only advances over a prefix of released blocks
+    while (!m_ringBlocks.empty() && m_ringBlocks.front().released) {
+        m_stagingTail = m_ringBlocks.front().end;
+        m_stagingUsed -= m_ringBlocks.front().consumed;
+        m_ringBlocks.pop_front();
+        m_firstRingBlock++;
+    }
+}
+
+void TransferManager::FlushStaging(const StagingRegion& region, VkDeviceSize size) {
+    // No-op on host-coherent memory
+    if (region.dedicatedAllocation != VK_NULL_HANDLE) {
+        vmaFlushAllocation(m_allocator, region.dedicatedAllocation, 0, size);
+    } else {
+        vmaFlushAllocation(m_allocator, m_stagingAllocation, region.offset, size);
+    }
 }
 
 } // namespace aero_boar
@@ -54,11 +54,17 @@ int WindowsMain() {
             }
         }
         
+        // Loads in the background; the triangle draws alone until the model is ready
         std::cout << "Loading model from: " << assetPath << std::endl;
-        if (!renderer.LoadModel(assetPath)) {
+        if (renderer.RequestModel(assetPath) == 0) {
             std::cerr << "Failed to load cube model, continuing with triangle only" << std::endl;
         }
 
+        // The rigged hand sits next to the cube; its instances animate once it is ready
+        std::string handPath = std::filesystem::path(assetPath).replace_filename("hand.glb").string();
+        ModelRequestId handRequest = renderer.RequestModel(handPath);
+        bool handsSpawned = false;
+
         std::cout << "Starting main loop..." << std::endl;
 
         // Set up input callbacks for input manager
@@ -100,6 +106,20 @@ int WindowsMain() {
             
             // Update camera
             renderer.UpdateCamera(deltaTime);
+
+            // A grid of hands, all skinned by the same dispatch
+            if (!handsSpawned && renderer.GetModelRequestStatus(handRequest) != ModelRequestStatus::Pending) {
+                if (renderer.GetModelRequestStatus(handRequest) == ModelRequestStatus::Ready) {
+                    for (int x = 0; x < 5; x++) {
+                        for (int z = 0; z < 5; z++) {
+                            glm::vec3 position((x - 2) * 0.5f, 0.0f, -2.0f - z * 0.5f);
+                            renderer.CreateAnimatedInstance(handPath, glm::translate(glm::mat4(1.0f), position));
+                        }
+                    }
+                }
+                handsSpawned = true;
+            }
+            renderer.UpdateAnimations(deltaTime);
             
             renderer.BeginFrame();
             renderer.Render();
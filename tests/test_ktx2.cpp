@@ -0,0 +1,145 @@
+#include "assets/ktx2.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace aero_boar;
+
+namespace {
+
+int g_failures = 0;
+
+void Check(bool condition, const char* message) {
+    if (!condition) {
+        std::cerr << "FAILED: " << message << std::endl;
+        g_failures++;
+    }
+}
+
+template<typename T>
+void WriteValue(std::vector<unsigned char>& bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// A 2D KTX2 file with the given level sizes, level 0 first. Levels are
+// stored smallest first as the spec lays them out, each filled with its
+// level number so the repacked data can be told apart.
+std::vector<unsigned char> MakeKtx2(uint32_t format, uint32_t width, uint32_t height,
+                                    const std::vector<uint64_t>& levelLengths, uint32_t supercompression = 0) {
+    const unsigned char identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    size_t levelCount = levelLengths.size();
+    size_t dataOffset = 80 + levelCount * 24;
+    size_t size = dataOffset;
+    for (uint64_t length : levelLengths) {
+        size += static_cast<size_t>(length);
+    }
+
+    std::vector<unsigned char> bytes(size, 0);
+    std::memcpy(bytes.data(), identifier, sizeof(identifier));
+    WriteValue<uint32_t>(bytes, 12, format);
+    WriteValue<uint32_t>(bytes, 16, 1);
+    WriteValue<uint32_t>(bytes, 20, width);
+    WriteValue<uint32_t>(bytes, 24, height);
+    WriteValue<uint32_t>(bytes, 36, 1);
+    WriteValue<uint32_t>(bytes, 40, static_cast<uint32_t>(levelCount));
+    WriteValue<uint32_t>(bytes, 44, supercompression);
+
+    size_t offset = dataOffset;
+    for (size_t level = levelCount; level-- > 0;) {
+        WriteValue<uint64_t>(bytes, 80 + level * 24, offset);
+        WriteValue<uint64_t>(bytes, 80 + level * 24 + 8, levelLengths[level]);
+        WriteValue<uint64_t>(bytes, 80 + level * 24 + 16, levelLengths[level]);
+        std::memset(bytes.data() + offset, static_cast<int>(level + 1), static_cast<size_t>(levelLengths[level]));
+        offset += static_cast<size_t>(levelLengths[level]);
+    }
+    return bytes;
+}
+
+// Bytes of every level of a full mip chain in blocks of blockBytes
+std::vector<uint64_t> BlockChain(uint32_t width, uint32_t height, uint32_t blockWidth, uint32_t blockHeight,
+                                 uint32_t blockBytes) {
+    std::vector<uint64_t> lengths;
+    for (uint32_t level = 0; (std::max(width, height) >> level) > 0; level++) {
+        uint64_t levelWidth = std::max(width >> level, 1u);
+        uint64_t levelHeight = std::max(height >> level, 1u);
+        lengths.push_back((levelWidth + blockWidth - 1) / blockWidth * ((levelHeight + blockHeight - 1) / blockHeight) *
+                          blockBytes);
+    }
+    return lengths;
+}
+
+bool Read(const std::vector<unsigned char>& bytes, Ktx2Image& image) {
+    std::string error;
+    return ReadKtx2(bytes.data(), bytes.size(), image, error);
+}
+
+void CheckRepack(const char* name, const std::vector<unsigned char>& bytes, const std::vector<uint64_t>& lengths) {
+    Ktx2Image image;
+    if (!Read(bytes, image)) {
+        Check(false, name);
+        return;
+    }
+    bool ok = image.mipLevels == lengths.size() && image.levelOffsets.size() == lengths.size();
+    for (size_t level = 0; ok && level < lengths.size(); level++) {
+        VkDeviceSize offset = image.levelOffsets[level];
+        ok = offset % 16 == 0 && offset + lengths[level] <= image.data.size() &&
+             std::all_of(image.data.begin() + offset, image.data.begin() + offset + lengths[level],
+                         [level](unsigned char byte) { return byte == level + 1; });
+    }
+    Check(ok, name);
+}
+
+// Reading a pre-transcoded file is parsing its index and repacking the
+// levels; there is no CPU decode. Best of several runs, in milliseconds.
+void BenchmarkRead(const char* name, const std::vector<unsigned char>& bytes) {
+    Ktx2Image image;
+    double best = 0.0;
+    for (int run = 0; run < 10; run++) {
+        auto start = std::chrono::steady_clock::now();
+        Read(bytes, image);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    std::cout << name << ": " << bytes.size() << " bytes, " << image.mipLevels << " levels read in " << best
+              << " ms" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    // BC7 and ASTC 6x6 chains, the latter with extents the blocks do not divide
+    std::vector<uint64_t> bc7Chain = BlockChain(256, 128, 4, 4, 16);
+    CheckRepack("BC7 mip chain", MakeKtx2(VK_FORMAT_BC7_UNORM_BLOCK, 256, 128, bc7Chain), bc7Chain);
+    std::vector<uint64_t> astcChain = BlockChain(100, 30, 6, 6, 16);
+    CheckRepack("ASTC 6x6 mip chain", MakeKtx2(VK_FORMAT_ASTC_6x6_SRGB_BLOCK, 100, 30, astcChain), astcChain);
+
+    // Basis Universal payloads need a transcoder this build does not have
+    Ktx2Image image;
+    Check(!Read(MakeKtx2(VK_FORMAT_UNDEFINED, 64, 64, { 64 }), image), "Basis Universal payload");
+    Check(!Read(MakeKtx2(VK_FORMAT_BC7_UNORM_BLOCK, 64, 64, { 4096 }, 2), image), "zstd supercompression");
+
+    // Levels must hold exactly their blocks and fit the mip chain
+    std::vector<uint64_t> shortLevel = bc7Chain;
+    shortLevel[1] -= 16;
+    Check(!Read(MakeKtx2(VK_FORMAT_BC7_UNORM_BLOCK, 256, 128, shortLevel), image), "level smaller than its blocks");
+    std::vector<uint64_t> extraLevel = bc7Chain;
+    extraLevel.push_back(16);
+    Check(!Read(MakeKtx2(VK_FORMAT_BC7_UNORM_BLOCK, 256, 128, extraLevel), image), "level past the mip chain");
+    std::vector<unsigned char> truncated = MakeKtx2(VK_FORMAT_BC7_UNORM_BLOCK, 256, 128, bc7Chain);
+    truncated.resize(truncated.size() - 1);
+    Check(!Read(truncated, image), "truncated level data");
+
+    if (g_failures > 0) {
+        return EXIT_FAILURE;
+    }
+    BenchmarkRead("BC7 2048x2048", MakeKtx2(VK_FORMAT_BC7_SRGB_BLOCK, 2048, 2048, BlockChain(2048, 2048, 4, 4, 16)));
+    BenchmarkRead("ASTC 6x6 2048x2048",
+                  MakeKtx2(VK_FORMAT_ASTC_6x6_SRGB_BLOCK, 2048, 2048, BlockChain(2048, 2048, 6, 6, 16)));
+    std::cout << "KTX2 tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
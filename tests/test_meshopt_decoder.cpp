@@ -0,0 +1,256 @@
+#include "assets/meshopt_decoder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace aero_boar;
+
+namespace {
+
+int g_failures = 0;
+
+void Check(bool condition, const char* message) {
+    if (!condition) {
+        std::cerr << "FAILED: " << message << std::endl;
+        g_failures++;
+    }
+}
+
+// Smallest encoding of sixteen zigzag deltas: 0, 2 or 4 bits with all-ones
+// values escaped to a trailing byte, or 8 bits raw. Returns the header code.
+int EncodeByteGroup(const unsigned char* deltas, std::vector<unsigned char>& stream) {
+    if (std::all_of(deltas, deltas + 16, [](unsigned char delta) { return delta == 0; })) {
+        return 0;
+    }
+
+    int bestCode = 3;
+    size_t bestSize = 16;
+    for (int code : { 1, 2 }) {
+        int bits = code == 1 ? 2 : 4;
+        unsigned char escape = static_cast<unsigned char>((1 << bits) - 1);
+        size_t size = 16 * bits / 8 + std::count_if(deltas, deltas + 16, [escape](unsigned char delta) {
+            return delta >= escape;
+        });
+        if (size < bestSize) {
+            bestCode = code;
+            bestSize = size;
+        }
+    }
+
+    if (bestCode == 3) {
+        stream.insert(stream.end(), deltas, deltas + 16);
+        return bestCode;
+    }
+
+    int bits = bestCode == 1 ? 2 : 4;
+    unsigned char escape = static_cast<unsigned char>((1 << bits) - 1);
+    std::vector<unsigned char> packed(16 * bits / 8, 0);
+    std::vector<unsigned char> escaped;
+    for (size_t i = 0; i < 16; i++) {
+        unsigned char value = deltas[i] >= escape ? escape : deltas[i];
+        size_t bit = i * bits;
+        packed[bit / 8] |= static_cast<unsigned char>(value << (8 - bits - bit % 8));
+        if (value == escape) {
+            escaped.push_back(deltas[i]);
+        }
+    }
+    stream.insert(stream.end(), packed.begin(), packed.end());
+    stream.insert(stream.end(), escaped.begin(), escaped.end());
+    return bestCode;
+}
+
+// Encodes vertices as a version 0 vertex stream, followed by a zeroed tail
+// the first deltas are taken against. Any valid encoding must decode the
+// same as the encoder's own.
+std::vector<unsigned char> EncodeVertexStream(const unsigned char* vertices, size_t count, size_t stride) {
+    std::vector<unsigned char> stream{ 0xa0 };
+    size_t blockSize = std::min<size_t>(256, (8192 / stride) & ~size_t(15));
+    std::vector<unsigned char> lastVertex(stride, 0);
+
+    for (size_t offset = 0; offset < count; offset += blockSize) {
+        size_t vertexCount = std::min(blockSize, count - offset);
+        size_t groupCount = (vertexCount + 15) / 16;
+        for (size_t k = 0; k < stride; k++) {
+            // Deltas against the same byte of the previous vertex; the
+            // padding past the last vertex repeats it
+            std::vector<unsigned char> deltas(groupCount * 16, 0);
+            unsigned char previous = lastVertex[k];
+            for (size_t i = 0; i < vertexCount; i++) {
+                unsigned char value = vertices[(offset + i) * stride + k];
+                unsigned char delta = static_cast<unsigned char>(value - previous);
+                deltas[i] = static_cast<unsigned char>((delta << 1) ^ -(delta >> 7));
+                previous = value;
+            }
+            lastVertex[k] = previous;
+
+            // Two header bits per group, then the groups
+            size_t headerOffset = stream.size();
+            stream.resize(stream.size() + (groupCount + 3) / 4, 0);
+            for (size_t group = 0; group < groupCount; group++) {
+                int code = EncodeByteGroup(&deltas[group * 16], stream);
+                stream[headerOffset + group / 4] |= static_cast<unsigned char>(code << ((group % 4) * 2));
+            }
+        }
+    }
+
+    stream.resize(stream.size() + (stride < 32 ? 32 : stride), 0);
+    return stream;
+}
+
+template <typename T>
+void CheckOctahedral(const char* name, const std::vector<T>& encoded, const std::vector<T>& expected) {
+    size_t stride = 4 * sizeof(T);
+    size_t count = encoded.size() / 4;
+    std::vector<unsigned char> stream =
+        EncodeVertexStream(reinterpret_cast<const unsigned char*>(encoded.data()), count, stride);
+
+    std::vector<T> decoded(encoded.size());
+    std::string error;
+    bool ok = DecodeMeshoptBufferView(stream.data(), stream.size(), count, stride, MeshoptMode::Attributes,
+                                      MeshoptFilter::Octahedral, reinterpret_cast<unsigned char*>(decoded.data()),
+                                      error);
+    Check(ok, name);
+    if (!ok) {
+        std::cerr << "  " << error << std::endl;
+        return;
+    }
+
+    // The reference decoder rounds the same way; allow one step for float
+    // evaluation order
+    for (size_t i = 0; i < decoded.size(); i++) {
+        if (std::abs(int(decoded[i]) - int(expected[i])) > 1) {
+            std::cerr << "  component " << i << ": " << int(decoded[i]) << ", expected " << int(expected[i])
+                      << std::endl;
+            Check(false, name);
+            return;
+        }
+    }
+}
+
+// A side x side grid of quantized vertices as an exporter would write them:
+// int16 position, int8 normal and uint16 texcoord, 16 bytes each
+std::vector<unsigned char> MakeGridVertices(size_t side) {
+    const size_t stride = 16;
+    std::vector<unsigned char> vertices(side * side * stride, 0);
+    for (size_t z = 0; z < side; z++) {
+        for (size_t x = 0; x < side; x++) {
+            float height = std::sin(x * 0.05f) * std::cos(z * 0.05f);
+            int16_t position[4] = { static_cast<int16_t>(x * 16), static_cast<int16_t>(height * 4096),
+                                    static_cast<int16_t>(z * 16), 0 };
+            int8_t normal[4] = { static_cast<int8_t>(-std::cos(x * 0.05f) * 40), 120,
+                                 static_cast<int8_t>(std::sin(z * 0.05f) * 40), 0 };
+            uint16_t texcoord[2] = { static_cast<uint16_t>(x * 64), static_cast<uint16_t>(z * 64) };
+            unsigned char* vertex = &vertices[(z * side + x) * stride];
+            std::memcpy(vertex, position, 8);
+            std::memcpy(vertex + 8, normal, 4);
+            std::memcpy(vertex + 12, texcoord, 4);
+        }
+    }
+    return vertices;
+}
+
+// Best of several runs, in milliseconds
+template<typename Function>
+double TimeBest(Function&& function) {
+    double best = 0.0;
+    for (int run = 0; run < 5; run++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+bool WriteFile(const std::filesystem::path& path, const std::vector<unsigned char>& bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+bool ReadFile(const std::filesystem::path& path, std::vector<unsigned char>& bytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+// Loading a compressed view costs reading the smaller file plus decoding it,
+// against reading the decoded bytes as they are. Files are read back warm
+// from the page cache, so the read times are a lower bound for a cold disk.
+void BenchmarkDecodeAgainstRead(const std::vector<unsigned char>& vertices, const std::vector<unsigned char>& stream,
+                                size_t count, size_t stride) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::filesystem::path compressedPath = directory / "aero_boar_meshopt_compressed.bin";
+    std::filesystem::path decodedPath = directory / "aero_boar_meshopt_decoded.bin";
+    if (!WriteFile(compressedPath, stream) || !WriteFile(decodedPath, vertices)) {
+        std::cerr << "Skipping decode benchmark: cannot write to " << directory << std::endl;
+        return;
+    }
+
+    std::vector<unsigned char> bytes;
+    std::vector<unsigned char> decoded(vertices.size());
+    std::string error;
+    double compressedRead = TimeBest([&]() { ReadFile(compressedPath, bytes); });
+    double decode = TimeBest([&]() {
+        DecodeMeshoptBufferView(stream.data(), stream.size(), count, stride, MeshoptMode::Attributes,
+                                MeshoptFilter::None, decoded.data(), error);
+    });
+    double decodedRead = TimeBest([&]() { ReadFile(decodedPath, bytes); });
+    std::filesystem::remove(compressedPath);
+    std::filesystem::remove(decodedPath);
+
+    double megabytes = static_cast<double>(vertices.size()) / (1024.0 * 1024.0);
+    std::cout << count << " vertices, " << vertices.size() << " bytes compressed to " << stream.size() << std::endl;
+    std::cout << "  read compressed " << compressedRead << " ms + decode " << decode << " ms ("
+              << megabytes / (decode / 1000.0) << " MB/s), read uncompressed " << decodedRead << " ms" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    // meshopt_encodeFilterOct output for (0.6, 0, 0.8) and (0.6, 0, -0.8) at
+    // 8 bits, and for (0.6, 0, -0.8) at 16 bits; w is the fourth input
+    CheckOctahedral<int8_t>("octahedral int8",
+                            { 54, 0, 127, 0, 127, 73, 127, 0 },
+                            { 76, 0, 102, 0, 76, 0, -102, 0 });
+    CheckOctahedral<int16_t>("octahedral int16",
+                             { 32767, 18724, 32767, 0 },
+                             { 19660, 0, -26214, 0 });
+
+    // A stream cut short must fail instead of reading past its end
+    std::vector<unsigned char> vertices(16, 0);
+    std::vector<unsigned char> stream = EncodeVertexStream(vertices.data(), 4, 4);
+    std::vector<unsigned char> decoded(16);
+    std::string error;
+    Check(!DecodeMeshoptBufferView(stream.data(), stream.size() - 1, 4, 4, MeshoptMode::Attributes,
+                                   MeshoptFilter::None, decoded.data(), error),
+          "truncated vertex stream");
+
+    // Many blocks of bit-packed groups must decode back to the vertices
+    const size_t side = 1024;
+    const size_t stride = 16;
+    std::vector<unsigned char> grid = MakeGridVertices(side);
+    std::vector<unsigned char> gridStream = EncodeVertexStream(grid.data(), side * side, stride);
+    std::vector<unsigned char> gridDecoded(grid.size());
+    Check(DecodeMeshoptBufferView(gridStream.data(), gridStream.size(), side * side, stride, MeshoptMode::Attributes,
+                                  MeshoptFilter::None, gridDecoded.data(), error) &&
+              gridDecoded == grid,
+          "multi-block vertex stream round trip");
+
+    if (g_failures > 0) {
+        return EXIT_FAILURE;
+    }
+    BenchmarkDecodeAgainstRead(grid, gridStream, side * side, stride);
+    std::cout << "meshopt decoder tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}